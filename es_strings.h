@@ -1,17 +1,27 @@
 static const char *es_strings = "\"  --help               Show program help.\" = \"  --help               Mostrar ayuda del programa.\";\n"
 "\"  --version            Show program version.\" = \"  --version            Mostrar versi√≥n del programa.\";\n"
 "\"  -A API-KEY           Specify LibreTranslate API key.\" = \"  -A API-KEY           Especifique la clave API de LibreTranslate.\";\n"
+"\"  -B BYTES             Specify number of bytes per request (translate).\" = \"  -B BYTES             Especifique el número de bytes por solicitud (translate).\";\n"
+"\"  -C                   Use a cache of scanned files (scan, sync).\" = \"  -C                   Usar una caché de archivos escaneados (scan, sync).\";\n"
+"\"  -F FORMAT            Specify report format (csv, json, text).\" = \"  -F FORMATO           Especifique el formato del informe (csv, json, text).\";\n"
+"\"  -M FILENAME          Specify translation memory file (translate).\" = \"  -M NOMBRE            Especifique el archivo de memoria de traducción (translate).\";\n"
 "\"  -T URL               Specify LibreTranslate server URL.\" = \"  -T URL               Spécifiez l'URL du serveur LibreTranslate.\";\n"
 "\"  -a                   Add new strings (import).\" = \"  -a                   A√±adir nuevas cuerdas (import).\";\n"
-"\"  -c                   Remove old strings (merge).\" = \"-c Quitar viejas cuerdas (merge.)\";\n"
+"\"  -b COUNT             Specify number of strings per request (translate).\" = \"  -b CANTIDAD          Especifique el número de cadenas por solicitud (translate).\";\n"
+"\"  -c                   Remove old strings (merge, sync).\" = \"  -c                   Quitar viejas cuerdas (merge, sync).\";\n"
 "\"  -f FILENAME.strings  Specify strings file.\" = \"  -f NOMBRE.strings    Especifique el archivo de cadenas.\";\n"
+"\"  -i PATTERN           Include matching files in directories (scan, sync).\" = \"  -i PATRÓN            Incluir archivos coincidentes en directorios (scan, sync).\";\n"
+"\"  -j JOBS              Specify number of parallel jobs (report, scan, sync, translate).\" = \"  -j TAREAS            Especifique el número de tareas en paralelo (report, scan, sync, translate).\";\n"
 "\"  -l LOCALE            Specify locale/language ID.\" = \"  -l LOCALE            Spécifiez l'identifiant de la langue/des paramètres régionaux.\";\n"
 "\"  -n NAME              Specify function/macro name for localization.\" = \"  -n NOMBRE            Especifique el nombre de función/macro para la localización.\";\n"
-"\"  export               Export strings to GNU gettext .po or C source file.\" = \"  export               Exportar cadenas a GNU gettext .po o archivo fuente C.\";\n"
-"\"  import               Import strings from GNU gettext .po or .strings file.\" = \"  import               Importar cadenas de GNU gettext .po o .strings file.\";\n"
+"\"  -v                   Show unlocalized strings (report).\" = \"  -v                   Mostrar cadenas no localizadas (report).\";\n"
+"\"  -x PATTERN           Exclude matching files and directories (scan, sync).\" = \"  -x PATRÓN            Excluir archivos y directorios coincidentes (scan, sync).\";\n"
+"\"  export               Export strings to GNU gettext .mo/.po or C source file.\" = \"  export               Exportar cadenas a GNU gettext .mo/.po o archivo fuente C.\";\n"
+"\"  import               Import strings from GNU gettext .mo/.po or .strings file.\" = \"  import               Importar cadenas de GNU gettext .mo/.po o .strings file.\";\n"
 "\"  merge                Merge strings from another strings file.\" = \"  merge                Combina cadenas de otro archivo de cadenas.\";\n"
 "\"  report               Report untranslated strings in the specified strings file(s).\" = \"  report               Informe cadenas no traducidas en el fichero(s) de cadenas especificadas.\";\n"
 "\"  scan                 Scan C/C++ source files for strings.\" = \"  scan                 Escanear archivos fuente C/C+ para cadenas.\";\n"
+"\"  sync                 Scan source files, then merge and export all locale strings files.\" = \"  sync                 Escanear archivos fuente, luego combinar y exportar todos los archivos de cadenas locales.\";\n"
 "\"  translate            Translate strings.\" = \"  translate            Traducir cadenas.\";\n"
 "\"Commands:\" = \"Comandos:\";\n"
 "\"Options:\" = \"Opciones:\";\n"
@@ -22,28 +32,42 @@ static const char *es_strings = "\"  --help               Show program help.\" =
 "\"stringsutil: '%s' is not translated in '%s'.\" = \"stringsutil: '%s' no está traducido en '%s'.\";\n"
 "\"stringsutil: '%s' needs to be merged, %d missing and %d old string(s).\" = \"stringsutil: '%s' necesita ser fusionado, %d faltantes y %d cadenas antiguas.\";\n"
 "\"stringsutil: 1 new string.\" = \"stringsutil: 1 nueva cuerda.\";\n"
+"\"stringsutil: Added %d string(s), removed %d string(s) in '%s'.\" = \"stringsutil: Añadido %d cadena(s), retirada %d cadena(s) en '%s'.\";\n"
 "\"stringsutil: Added %d string(s), removed %d string(s).\" = \"stringsutil: A√±adido %d cuerda(s), retirada %d cuerda(s).\";\n"
 "\"stringsutil: Expected %s filename.\" = \"stringsutil: Nombre de archivo %s esperado.\";\n"
 "\"stringsutil: Expected '-n FUNCTION-NAME' option.\" = \"stringsutil: Opci√≥n esperada '-n NOMBRE'.\";\n"
 "\"stringsutil: Expected LibreTranslate API key after '-A'.\" = \"stringsutil: La clave de la API LibreTranslate esperada después de -A.\";\n"
 "\"stringsutil: Expected LibreTranslate URL after '-T'.\" = \"stringsutil: Expected LibreTranslate URL después -T.\";\n"
 "\"stringsutil: Expected command name.\" = \"stringsutil: Nombre de comando esperado.\";\n"
+"\"stringsutil: Expected filename pattern after '-i'.\" = \"stringsutil: Patrón de nombre de archivo esperado después de '-i'.\";\n"
+"\"stringsutil: Expected filename pattern after '-x'.\" = \"stringsutil: Patrón de nombre de archivo esperado después de '-x'.\";\n"
 "\"stringsutil: Expected function name after '-n'.\" = \"stringsutil: Nombre de función esperado después de '-n'.\";\n"
 "\"stringsutil: Expected language code after '-l'.\" = \"stringsutil: Código de idioma esperado después de -l.\";\n"
+"\"stringsutil: Expected number of bytes after '-B'.\" = \"stringsutil: Número de bytes esperado después de '-B'.\";\n"
+"\"stringsutil: Expected number of jobs after '-j'.\" = \"stringsutil: Número de tareas esperado después de '-j'.\";\n"
+"\"stringsutil: Expected number of strings after '-b'.\" = \"stringsutil: Número de cadenas esperado después de '-b'.\";\n"
+"\"stringsutil: Expected report format after '-F'.\" = \"stringsutil: Formato de informe esperado después de '-F'.\";\n"
+"\"stringsutil: Expected source filename(s).\" = \"stringsutil: Nombre(s) de archivo fuente esperado(s).\";\n"
 "\"stringsutil: Expected strings file.\" = \"stringsutil: Archivo de cadenas esperadas.\";\n"
 "\"stringsutil: Expected strings filename after '-f'.\" = \"stringsutil: Nombre de archivo de cadenas esperadas despu√©s '-f'.\";\n"
+"\"stringsutil: Expected translation memory filename after '-M'.\" = \"stringsutil: Nombre de archivo de memoria de traducción esperado después de '-M'.\";\n"
+"\"stringsutil: Found %lu string(s) in translation memory.\" = \"stringsutil: Se encontraron %lu cadena(s) en la memoria de traducción.\";\n"
 "\"stringsutil: Ignoring old string '%s'...\" = \"stringsutil: Ignorando la cadena antigua '%s'.\";\n"
 "\"stringsutil: Invalid LibreTranslate URL '%s'.\" = \"stringsutil: Invalid LibreTranslate URL %s.\";\n"
 "\"stringsutil: Localized as '%s'.\" = \"stringsutil: Localizado como %s.\";\n"
 "\"stringsutil: Lost connection to translation server: %s\" = \"stringsutil: Se perdió la conexión con el servidor de traducción: %s\";\n"
 "\"stringsutil: No new strings.\" = \"stringsutil: No hay nuevas cuerdas.\";\n"
 "\"stringsutil: No strings in '%s'.\" = \"stringsutil: Sin cuerdas en '%s'.\";\n"
+"\"stringsutil: Resuming %lu translation(s) from '%s'.\" = \"stringsutil: Reanudando %lu traducción(es) desde '%s'.\";\n"
+"\"stringsutil: Scanned %d of %d files.\" = \"stringsutil: Escaneados %d de %d archivos.\";\n"
+"\"stringsutil: Sent %lu unique string(s) for %lu string(s), %lu%% duplicates.\" = \"stringsutil: Enviada(s) %lu cadena(s) única(s) para %lu cadena(s), %lu%% duplicados.\";\n"
 "\"stringsutil: Syntax error on line %d of '%s'.\" = \"stringsutil: Error sintaxis en l√≠nea %d de '%s'.\";\n"
 "\"stringsutil: Too many files.\" = \"stringsutil: Demasiados archivos.\";\n"
 "\"stringsutil: Translated %d string(s).\" = \"stringsutil: Traducido %d string(s.)\";\n"
 "\"stringsutil: Translated format string does not match '%s' in '%s'.\" = \"stringsutil: La cadena de formato traducido no coincide con %s en '%s'.\";\n"
 "\"stringsutil: Translating %lu strings to '%s'...\" = \"stringsutil: Traduciendo cadenas %lu a '%s'...\";\n"
 "\"stringsutil: Translating '%s'...\" = \"stringsutil: Traduciendo %s.\";\n"
+"\"stringsutil: Unable to allocate memory: %s\" = \"stringsutil: Incapaz de asignar memoria: %s\";\n"
 "\"stringsutil: Unable to connect to '%s': %s\" = \"stringsutil: Incapaz de conectar a %s: %s\";\n"
 /* Unable to create .strings file */
 "\"stringsutil: Unable to create '%s': %s\\n\" = \"stringsutil: Incapaz de crear '%s': %s\\n\";\n"
@@ -52,10 +76,16 @@ static const char *es_strings = "\"  --help               Show program help.\" =
 "\"stringsutil: Unable to load '%s': %s\" = \"stringsutil: Incapaz de cargar '%s': %s\";\n"
 "\"stringsutil: Unable to merge '%s': %s\" = \"stringsutil: Incapaz de combinar '%s': %s\";\n"
 "\"stringsutil: Unable to open source file '%s': %s\" = \"stringsutil: Incapaz de abrir el archivo fuente '%s': %s\";\n"
+"\"stringsutil: Unable to open translation journal '%s': %s\" = \"stringsutil: Incapaz de abrir el diario de traducción '%s': %s\";\n"
+"\"stringsutil: Unable to open translation memory '%s': %s\" = \"stringsutil: Incapaz de abrir la memoria de traducción '%s': %s\";\n"
 "\"stringsutil: Unable to report on '%s': %s\" = \"stringsutil: Incapaces de informar sobre '%s': %s\";\n"
+"\"stringsutil: Unable to scan source files: %s\" = \"stringsutil: Incapaz de escanear los archivos fuente: %s\";\n"
 "\"stringsutil: Unable to send translation request: %s\" = \"stringsutil: No se puede enviar la solicitud de traducción: %s\";\n"
 "\"stringsutil: Unable to translate '%s': %s\" = \"stringsutil: Incapaz de traducir %s: %s\";\n"
 "\"stringsutil: Unable to translate from '%s': %s\" = \"stringsutil: Incapaz de traducir desde %s: %s\";\n"
+"\"stringsutil: Unable to write scan cache '%s': %s\" = \"stringsutil: Incapaz de escribir la caché de escaneo '%s': %s\";\n"
+"\"stringsutil: Unable to write translation journal '%s': %s\" = \"stringsutil: Incapaz de escribir el diario de traducción '%s': %s\";\n"
+"\"stringsutil: Unable to write translation memory '%s': %s\" = \"stringsutil: Incapaz de escribir la memoria de traducción '%s': %s\";\n"
 "\"stringsutil: Unknown export format for '%s'.\" = \"stringsutil: Formato de exportaci√≥n desconocido '%s'.\";\n"
 "\"stringsutil: Unknown import format for '%s'.\" = \"stringsutil: Formato de importaci√≥n desconocido '%s'.\";\n"
 "\"stringsutil: Unknown option '%s'.\" = \"stringsutil: Opci√≥n desconocida '%s'.\";\n"
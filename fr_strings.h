@@ -1,17 +1,27 @@
 static const char *fr_strings = "\"  --help               Show program help.\" = \"  --help               Afficher l'aide du programme.\";\n"
 "\"  --version            Show program version.\" = \"  --version            Afficher la version du programme.\";\n"
 "\"  -A API-KEY           Specify LibreTranslate API key.\" = \"  -A API-KEY           Spécifiez la clé API LibreTranslate.\";\n"
+"\"  -B BYTES             Specify number of bytes per request (translate).\" = \"  -B BYTES             Spécifiez le nombre d'octets par requête (translate).\";\n"
+"\"  -C                   Use a cache of scanned files (scan, sync).\" = \"  -C                   Utiliser un cache des fichiers analysés (scan, sync).\";\n"
+"\"  -F FORMAT            Specify report format (csv, json, text).\" = \"  -F FORMAT            Spécifiez le format du rapport (csv, json, text).\";\n"
+"\"  -M FILENAME          Specify translation memory file (translate).\" = \"  -M NOM               Spécifiez le fichier de mémoire de traduction (translate).\";\n"
 "\"  -T URL               Specify LibreTranslate server URL.\" = \"  -T URL               Spécifiez l'URL du serveur LibreTranslate.\";\n"
 "\"  -a                   Add new strings (import).\" = \"  -a                   Ajouter de nouvelles chaînes (import).\";\n"
-"\"  -c                   Remove old strings (merge).\" = \"  -c                   Retirer les vieilles chaînes (merge).\";\n"
+"\"  -b COUNT             Specify number of strings per request (translate).\" = \"  -b NOMBRE            Spécifiez le nombre de chaînes par requête (translate).\";\n"
+"\"  -c                   Remove old strings (merge, sync).\" = \"  -c                   Retirer les vieilles chaînes (merge, sync).\";\n"
 "\"  -f FILENAME.strings  Specify strings file.\" = \"  -f NOM.strings       Spécifiez le fichier chaîne.\";\n"
+"\"  -i PATTERN           Include matching files in directories (scan, sync).\" = \"  -i MOTIF             Inclure les fichiers correspondants dans les répertoires (scan, sync).\";\n"
+"\"  -j JOBS              Specify number of parallel jobs (report, scan, sync, translate).\" = \"  -j TÂCHES            Spécifiez le nombre de tâches parallèles (report, scan, sync, translate).\";\n"
 "\"  -l LOCALE            Specify locale/language ID.\" = \"  -l LOCALE            Indiquez l'identifiant local/langue.\";\n"
 "\"  -n NAME              Specify function/macro name for localization.\" = \"  -n NOM               Spécifiez le nom de la fonction/macro pour la localisation.\";\n"
-"\"  export               Export strings to GNU gettext .po or C source file.\" = \"  export               Exporter des chaînes vers le fichier source GNU gettext .po ou C.\";\n"
-"\"  import               Import strings from GNU gettext .po or .strings file.\" = \"  import               Importer des chaînes de fichiers GNU gettext .po ou .strings.\";\n"
+"\"  -v                   Show unlocalized strings (report).\" = \"  -v                   Afficher les chaînes non localisées (report).\";\n"
+"\"  -x PATTERN           Exclude matching files and directories (scan, sync).\" = \"  -x MOTIF             Exclure les fichiers et répertoires correspondants (scan, sync).\";\n"
+"\"  export               Export strings to GNU gettext .mo/.po or C source file.\" = \"  export               Exporter des chaînes vers le fichier source GNU gettext .mo/.po ou C.\";\n"
+"\"  import               Import strings from GNU gettext .mo/.po or .strings file.\" = \"  import               Importer des chaînes de fichiers GNU gettext .mo/.po ou .strings.\";\n"
 "\"  merge                Merge strings from another strings file.\" = \"  merge                Fusionner les chaînes d'un autre fichier chaîne.\";\n"
 "\"  report               Report untranslated strings in the specified strings file(s).\" = \"  report               Signaler des chaînes non traduites dans le ou les fichiers de chaînes sp√©cifi√©s.\";\n"
 "\"  scan                 Scan C/C++ source files for strings.\" = \"  scan                 Scanner les fichiers sources C/C+ pour les chaînes.\";\n"
+"\"  sync                 Scan source files, then merge and export all locale strings files.\" = \"  sync                 Scanner les fichiers sources, puis fusionner et exporter tous les fichiers de chaînes locales.\";\n"
 "\"  translate            Translate strings.\" = \"  translate            Traduire les chaînes de caractères.\";\n"
 "\"Commands:\" = \"Commandes:\";\n"
 "\"Options:\" = \"Choix:\";\n"
@@ -22,28 +32,42 @@ static const char *fr_strings = "\"  --help               Show program help.\" =
 "\"stringsutil: '%s' is not translated in '%s'.\" = \"stringsutil: '%s' n'est pas traduit en '%s'.\";\n"
 "\"stringsutil: '%s' needs to be merged, %d missing and %d old string(s).\" = \"stringsutil: '%s' doit être fusionné, %d manquant et %d anciennes chaînes.\";\n"
 "\"stringsutil: 1 new string.\" = \"stringsutil: 1 nouvelle chaîne.\";\n"
+"\"stringsutil: Added %d string(s), removed %d string(s) in '%s'.\" = \"stringsutil: Ajout de %d chaîne(s), suppression de %d chaîne(s) dans '%s'.\";\n"
 "\"stringsutil: Added %d string(s), removed %d string(s).\" = \"stringsutil: Ajout de chaînes %d, suppression de chaînes %d.\";\n"
 "\"stringsutil: Expected %s filename.\" = \"stringsutil: Nom de fichier attendu %s.\";\n"
 "\"stringsutil: Expected '-n FUNCTION-NAME' option.\" = \"stringsutil: Option prévue '-n NOM'.\";\n"
 "\"stringsutil: Expected LibreTranslate API key after '-A'.\" = \"stringsutil: La clé de l'API LibreTranslate attendue après -A.\";\n"
 "\"stringsutil: Expected LibreTranslate URL after '-T'.\" = \"stringsutil: attendu LibreTranslate URL après -T.\";\n"
 "\"stringsutil: Expected command name.\" = \"stringsutil: Nom de commandement attendu.\";\n"
+"\"stringsutil: Expected filename pattern after '-i'.\" = \"stringsutil: Motif de nom de fichier attendu après '-i'.\";\n"
+"\"stringsutil: Expected filename pattern after '-x'.\" = \"stringsutil: Motif de nom de fichier attendu après '-x'.\";\n"
 "\"stringsutil: Expected function name after '-n'.\" = \"stringsutil: Nom de fonction attendu après '-n'.\";\n"
 "\"stringsutil: Expected language code after '-l'.\" = \"stringsutil: Code de langue attendu après -l.\";\n"
+"\"stringsutil: Expected number of bytes after '-B'.\" = \"stringsutil: Nombre d'octets attendu après '-B'.\";\n"
+"\"stringsutil: Expected number of jobs after '-j'.\" = \"stringsutil: Nombre de tâches attendu après '-j'.\";\n"
+"\"stringsutil: Expected number of strings after '-b'.\" = \"stringsutil: Nombre de chaînes attendu après '-b'.\";\n"
+"\"stringsutil: Expected report format after '-F'.\" = \"stringsutil: Format de rapport attendu après '-F'.\";\n"
+"\"stringsutil: Expected source filename(s).\" = \"stringsutil: Nom(s) de fichier source attendu(s).\";\n"
 "\"stringsutil: Expected strings file.\" = \"stringsutil: Fichier de chaîne attendu.\";\n"
 "\"stringsutil: Expected strings filename after '-f'.\" = \"stringsutil: Nom de fichier des chaînes attendu après '-f'.\";\n"
+"\"stringsutil: Expected translation memory filename after '-M'.\" = \"stringsutil: Nom de fichier de mémoire de traduction attendu après '-M'.\";\n"
+"\"stringsutil: Found %lu string(s) in translation memory.\" = \"stringsutil: %lu chaîne(s) trouvée(s) dans la mémoire de traduction.\";\n"
 "\"stringsutil: Ignoring old string '%s'...\" = \"stringsutil: Ignorer l'ancienne chaîne '%s'.\";\n"
 "\"stringsutil: Invalid LibreTranslate URL '%s'.\" = \"stringsutil: Invalid LibreTranslate URL %s.\";\n"
 "\"stringsutil: Localized as '%s'.\" = \"stringsutil: Localisé en '%s'.\";\n"
 "\"stringsutil: Lost connection to translation server: %s\" = \"stringsutil: Connexion au serveur de traduction perdue : %s\";\n"
 "\"stringsutil: No new strings.\" = \"stringsutil: Pas de nouvelles chaînes.\";\n"
 "\"stringsutil: No strings in '%s'.\" = \"stringsutil: Pas de chaînes dans '%s'.\";\n"
+"\"stringsutil: Resuming %lu translation(s) from '%s'.\" = \"stringsutil: Reprise de %lu traduction(s) depuis '%s'.\";\n"
+"\"stringsutil: Scanned %d of %d files.\" = \"stringsutil: %d fichiers analysés sur %d.\";\n"
+"\"stringsutil: Sent %lu unique string(s) for %lu string(s), %lu%% duplicates.\" = \"stringsutil: Envoi de %lu chaîne(s) unique(s) pour %lu chaîne(s), %lu%% de doublons.\";\n"
 "\"stringsutil: Syntax error on line %d of '%s'.\" = \"stringsutil: Erreur de syntaxe sur la ligne %d de '%s'.\";\n"
 "\"stringsutil: Too many files.\" = \"stringsutil: Trop de fichiers.\";\n"
 "\"stringsutil: Translated %d string(s).\" = \"stringsutil: Translated %d string(s.)\";\n"
 "\"stringsutil: Translated format string does not match '%s' in '%s'.\" = \"stringsutil: Chaîne de format traduit ne correspond pas aux %s dans '%s'.\";\n"
 "\"stringsutil: Translating %lu strings to '%s'...\" = \"stringsutil: Traduction des chaînes %lu en '%s'...\";\n"
 "\"stringsutil: Translating '%s'...\" = \"stringsutil: Traduire des %s.\";\n"
+"\"stringsutil: Unable to allocate memory: %s\" = \"stringsutil: Incapable d'allouer de la mémoire: %s\";\n"
 "\"stringsutil: Unable to connect to '%s': %s\" = \"stringsutil: Incapable de se connecter ‡0e0 %s: %s\";\n"
 /* Unable to create .strings file */
 "\"stringsutil: Unable to create '%s': %s\\n\" = \"stringsutil: Incapable de créer des '%s': %s\\n\";\n"
@@ -52,10 +76,16 @@ static const char *fr_strings = "\"  --help               Show program help.\" =
 "\"stringsutil: Unable to load '%s': %s\" = \"stringsutil: Incapable d'charger '%s': %s\";\n"
 "\"stringsutil: Unable to merge '%s': %s\" = \"stringsutil: Incapable d'fusionner '%s': %s\";\n"
 "\"stringsutil: Unable to open source file '%s': %s\" = \"stringsutil: Incapable d'ouvrir le fichier source '%s': %s\";\n"
+"\"stringsutil: Unable to open translation journal '%s': %s\" = \"stringsutil: Incapable d'ouvrir le journal de traduction '%s': %s\";\n"
+"\"stringsutil: Unable to open translation memory '%s': %s\" = \"stringsutil: Incapable d'ouvrir la mémoire de traduction '%s': %s\";\n"
 "\"stringsutil: Unable to report on '%s': %s\" = \"stringsutil: Incapable de faire rapport '%s': %s\";\n"
+"\"stringsutil: Unable to scan source files: %s\" = \"stringsutil: Incapable d'analyser les fichiers sources: %s\";\n"
 "\"stringsutil: Unable to send translation request: %s\" = \"stringsutil: Impossible d'envoyer la demande de traduction : %s\";\n"
 "\"stringsutil: Unable to translate '%s': %s\" = \"stringsutil: Incapable de traduire %s: %s\";\n"
 "\"stringsutil: Unable to translate from '%s': %s\" = \"stringsutil: Incapable de traduire ‡0e0 partir de %s: %s\";\n"
+"\"stringsutil: Unable to write scan cache '%s': %s\" = \"stringsutil: Incapable d'écrire le cache d'analyse '%s': %s\";\n"
+"\"stringsutil: Unable to write translation journal '%s': %s\" = \"stringsutil: Incapable d'écrire le journal de traduction '%s': %s\";\n"
+"\"stringsutil: Unable to write translation memory '%s': %s\" = \"stringsutil: Incapable d'écrire la mémoire de traduction '%s': %s\";\n"
 "\"stringsutil: Unknown export format for '%s'.\" = \"stringsutil: Format d'exportation inconnu '%s'.\";\n"
 "\"stringsutil: Unknown import format for '%s'.\" = \"stringsutil: Format d'importation inconnu '%s'.\";\n"
 "\"stringsutil: Unknown option '%s'.\" = \"stringsutil: Option inconnue '%s'.\";\n"
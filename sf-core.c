@@ -1,7 +1,7 @@
 //
 // Core strings file functions for StringsUtil.
 //
-// Copyright © 2022 by Michael R Sweet.
+// Copyright © 2022-2026 by Michael R Sweet.
 //
 // Licensed under Apache License v2.0.  See the file "LICENSE" for more
 // information.
@@ -15,9 +15,21 @@
 // Local functions...
 //
 
+static void	sf_add_stats(sf_t *sf, size_t lookups, size_t hits, size_t filtered, size_t false_positives);
+static size_t	sf_build_index(sf_t *sf, size_t i, size_t k);
+static void	sf_build_skip(sf_t *sf, size_t k, size_t lo, size_t hi);
+static bool	sf_check_filter(sf_t *sf, uint64_t hash);
 static int	sf_compare_pairs(_sf_pair_t *a, _sf_pair_t *b);
+static _sf_pair_t *sf_find_index(sf_t *sf, const char *key);
+static size_t	sf_find_indexes(sf_t *sf, const char **keys, size_t num_keys, _sf_pair_t **matches, bool *filtered);
 static void	sf_free_pair(_sf_pair_t *pair);
+static uint64_t	sf_hash_key(const char *key);
+static uint64_t	sf_key_prefix(const char *key);
+static const char *sf_lookup(sf_t *sf, const char *key);
 static void	sf_sort(sf_t *sf);
+static size_t	sf_step_index(sf_t *sf, const char *key, size_t k, _sf_pair_t **match);
+static void	sf_update_index(sf_t *sf);
+static uint64_t	sf_word_filter(uint64_t hash);
 
 
 //
@@ -49,6 +61,7 @@ _sfAddPair(sf_t       *sf,		// I - Localization strings
   pair->key     = strdup(key);
   pair->text    = strdup(text);
   pair->comment = comment && *comment ? strdup(comment) : NULL;
+  pair->format  = NULL;
 
   if (!pair->key || !pair->text || (!pair->comment && comment && *comment))
   {
@@ -57,6 +70,7 @@ _sfAddPair(sf_t       *sf,		// I - Localization strings
   }
 
   sf->num_pairs ++;
+  sf->num_index = 0;
   sf->need_sort = sf->num_pairs > 1;
 
   return (pair);
@@ -82,6 +96,12 @@ sfAddString(sf_t       *sf,		// I - Strings
   if (!sf || !key || !text)
     return (false);
 
+  if (sf->shared)
+  {
+    _sfSetError(sf, "Shared catalogs cannot be modified.");
+    return (false);
+  }
+
   _sf_rwlock_wrlock(sf->rwlock);
 
   pair = _sfAddPair(sf, key, text, comment);
@@ -95,6 +115,45 @@ sfAddString(sf_t       *sf,		// I - Strings
 }
 
 
+//
+// '_sfCompileFormats()' - Compute the format signatures of all keys.
+//
+// The signature of each key containing formats is saved in the "format"
+// member of the pair, or "!" if the key is not a valid format string, so that
+// localized text can be checked with @link _sfFormatSignature@ and `strcmp`.
+//
+
+bool					// O - `true` on success, `false` on error
+_sfCompileFormats(sf_t *sf)		// I - Localization strings
+{
+  _sf_pair_t	*pair;			// Current pair
+  size_t	count;			// Number of pairs remaining
+  char		sig[2048];		// Format signature
+
+
+  for (count = sf->num_pairs, pair = sf->pairs; count > 0; count --, pair ++)
+  {
+    if (pair->format || !strchr(pair->key, '%'))
+      continue;
+
+    if (!_sfFormatSignature(pair->key, sig, sizeof(sig)))
+      pair->format = strdup("!");
+    else if (sig[0])
+      pair->format = strdup(sig);
+    else
+      continue;
+
+    if (!pair->format)
+    {
+      _sfSetError(sf, "Unable to allocate memory for format signature.");
+      return (false);
+    }
+  }
+
+  return (true);
+}
+
+
 //
 // 'sfDelete()' - Free a collection of localization strings.
 //
@@ -105,6 +164,7 @@ void
 sfDelete(sf_t *sf)			// I - Localization strings
 {
   _sf_pair_t	*pair;			// Current pair
+  _sf_mo_t	*mo;			// Current message catalog
   size_t	count;			// Number of pairs
 
 
@@ -115,10 +175,26 @@ sfDelete(sf_t *sf)			// I - Localization strings
   // Free memory...
   _sf_rwlock_destroy(sf->rwlock);
 
+#ifndef _WIN32
+  if (sf->shared)
+    munmap((void *)sf->shared, sf->shared_size);
+#endif // !_WIN32
+
   for (count = sf->num_pairs, pair = sf->pairs; count > 0; count --, pair ++)
     sf_free_pair(pair);
 
+  for (count = sf->num_mos, mo = sf->mos; count > 0; count --, mo ++)
+  {
+#ifdef _WIN32
+    free((void *)mo->data);
+#else
+    munmap((void *)mo->data, mo->size);
+#endif // _WIN32
+  }
+
   free(sf->pairs);
+  free(sf->mos);
+  free(sf->index_data);
   free(sf);
 }
 
@@ -131,13 +207,141 @@ _sf_pair_t *				// O - Matching pair or `NULL`
 _sfFindPair(sf_t       *sf,		// I - Strings
             const char *key)		// I - Key
 {
-  _sf_pair_t	pair;			// Search key
+  _sf_pair_t	pair,			// Search key
+		*match;			// Matching pair
+
+
+  if (sf->num_index && sf->num_index == sf->num_pairs)
+  {
+    // Use the filter to reject most missing keys, then the search index...
+    if (!sf_check_filter(sf, sf_hash_key(key)))
+      return (NULL);
+
+    match = sf_find_index(sf, key);
+  }
+  else
+  {
+    memset(&pair, 0, sizeof(pair));
+    pair.key = (char *)key;
+
+    match = (_sf_pair_t *)bsearch(&pair, sf->pairs, sf->num_pairs, sizeof(_sf_pair_t), (int (*)(const void *, const void *))sf_compare_pairs);
+  }
+
+  return (match);
+}
+
+
+//
+// '_sfFormatSignature()' - Get the format signature of a string.
+//
+// The signature lists the conversion specification (flags, width, precision,
+// length, and conversion character) of each argument in order, each starting
+// with a "%".  Positional ("%N$") arguments are put in their position, so two
+// strings with matching formats have identical signatures.  The signature of
+// a string without formats is the empty string.
+//
+// `false` is returned if an argument is missing, an argument is used with two
+// different conversions, or there are too many arguments.
+//
+
+bool					// O - `true` on success, `false` if invalid
+_sfFormatSignature(const char *s,	// I - String
+                   char       *sig,	// I - Signature buffer
+                   size_t     sigsize)	// I - Size of signature buffer
+{
+  int		i = 0,			// Current argument
+		num_args = 0;		// Number of arguments
+  const char	*ptr,			// Pointer into string
+		*start,			// Start of conversion
+		*specs[_SF_MAX_FORMATS];// Conversion for each argument
+  size_t	lens[_SF_MAX_FORMATS];	// Length of each conversion
+  char		*sigptr,		// Pointer into signature
+		*sigend;		// End of signature
+
+
+  // Find the conversion for each argument...
+  for (ptr = strchr(s, '%'); ptr; ptr = strchr(ptr, '%'))
+  {
+    ptr ++;
+    if (*ptr == '%')
+    {
+      // Skip %%...
+      ptr ++;
+      continue;
+    }
 
+    if (isdigit(*ptr & 255) && ptr[1] == '$')
+    {
+      // 1-digit positional parameter
+      i   = *ptr - '1';
+      ptr += 2;
+    }
+    else if (isdigit(*ptr & 255) && isdigit(ptr[1] & 255) && ptr[2] == '$')
+    {
+      // 2-digit positional parameter
+      i = (*ptr - '0') * 10 + ptr[1] - '1';
+      ptr += 3;
+    }
+
+    if (i < 0 || i >= _SF_MAX_FORMATS)
+      return (false);
+
+    // The conversion ends with the first letter that isn't a length modifier...
+    for (start = ptr; *ptr && *ptr != '%'; ptr ++)
+    {
+      if (isalpha(*ptr & 255) && !strchr("hjlLqtz", *ptr))
+      {
+        ptr ++;
+        break;
+      }
+    }
+
+    while (num_args <= i)
+      specs[num_args ++] = NULL;
+
+    if (specs[i] && (lens[i] != (size_t)(ptr - start) || memcmp(specs[i], start, lens[i])))
+      return (false);
+
+    specs[i] = start;
+    lens[i]  = (size_t)(ptr - start);
+    i ++;
+  }
+
+  // Then build the signature...
+  for (i = 0, sigptr = sig, sigend = sig + sigsize - 1; i < num_args; i ++)
+  {
+    if (!specs[i] || (sigptr + lens[i] + 1) > sigend)
+      return (false);
 
-  memset(&pair, 0, sizeof(pair));
-  pair.key = (char *)key;
+    *sigptr++ = '%';
+    memcpy(sigptr, specs[i], lens[i]);
+    sigptr += lens[i];
+  }
 
-  return ((_sf_pair_t *)bsearch(&pair, sf->pairs, sf->num_pairs, sizeof(_sf_pair_t), (int (*)(const void *, const void *))sf_compare_pairs));
+  *sigptr = '\0';
+
+  return (true);
+}
+
+
+//
+// 'sfEnableStats()' - Enable or disable lookup statistics.
+//
+// This function controls whether @link sfGetString@, @link sfGetStrings@, and
+// @link sfHasString@ count their lookups for @link sfGetStats@.  Statistics
+// are disabled by default since counting adds a shared write to every lookup.
+// Enable them before any other threads start using the localization strings.
+//
+
+void
+sfEnableStats(sf_t *sf,			// I - Localization strings or `NULL` for the default
+              bool enable)		// I - `true` to collect statistics, `false` to stop
+{
+  if (!sf)
+    sf = _sfGetDefault();
+
+  if (sf)
+    sf->stats_enabled = enable;
 }
 
 
@@ -197,6 +401,39 @@ sfGetError(sf_t *sf)			// I - Localization strings
 }
 
 
+//
+// 'sfGetStats()' - Get lookup statistics.
+//
+// This function gets the number of lookups, the number of lookups that found a
+// localized string, and for the lookups that did not, how many were rejected
+// by the filter that is built for the localization strings and how many had to
+// search for the string (false positives).  Statistics are only collected after
+// calling @link sfEnableStats@.
+//
+
+void
+sfGetStats(sf_t       *sf,		// I - Localization strings or `NULL` for the default
+           sf_stats_t *stats)		// O - Lookup statistics
+{
+  if (!stats)
+    return;
+
+  if (!sf)
+    sf = _sfGetDefault();
+
+  if (!sf)
+  {
+    memset(stats, 0, sizeof(sf_stats_t));
+    return;
+  }
+
+  stats->lookups         = _sf_atomic_get(sf->stats.lookups);
+  stats->hits            = _sf_atomic_get(sf->stats.hits);
+  stats->filtered        = _sf_atomic_get(sf->stats.filtered);
+  stats->false_positives = _sf_atomic_get(sf->stats.false_positives);
+}
+
+
 //
 // 'sfGetString()' - Lookup a localized string.
 //
@@ -212,7 +449,6 @@ const char *				// O - Localized string
 sfGetString(sf_t       *sf,		// I - Localization strings or `NULL` for the default
             const char *key)		// I - Key string
 {
-  _sf_pair_t	*match;			// Matching pair, if any
   const char	*s;			// Matching string
 
 
@@ -223,11 +459,20 @@ sfGetString(sf_t       *sf,		// I - Localization strings or `NULL` for the defau
   if (!key || !sf)
     return (key);
 
+  if (sf->shared)
+  {
+    // Shared catalogs are read-only and don't need a lock...
+    s = _sfGetShared(sf, key);
+
+    if (sf->stats_enabled)
+      sf_add_stats(sf, 1, s != NULL, 0, 0);
+
+    return (s ? s : key);
+  }
+
   // Look up the key...
   _sf_rwlock_rdlock(sf->rwlock);
-  if ((match = _sfFindPair(sf, key)) != NULL)
-    s = match->text;
-  else
+  if ((s = sf_lookup(sf, key)) == NULL)
     s = key;
   _sf_rwlock_unlock(sf->rwlock);
 
@@ -236,6 +481,141 @@ sfGetString(sf_t       *sf,		// I - Localization strings or `NULL` for the defau
 }
 
 
+//
+// 'sfGetStrings()' - Lookup multiple localized strings.
+//
+// This function looks up the localized strings for an array of key strings,
+// storing the localized string for each key in the corresponding element of
+// the "texts" array.  If no localization exists for a key, the key string is
+// stored instead.
+//
+// Looking up many strings at once is faster than calling @link sfGetString@
+// for each one since the localization strings are only locked once and the
+// memory accesses for the lookups are overlapped.
+//
+// The default localization strings ("sf" passed as `NULL`) are initialized
+// using the @link sfSetLocale@, @link sfRegisterDirectory@, and
+// @link sfRegisterString@ functions.
+//
+
+size_t					// O - Number of localized strings found
+sfGetStrings(sf_t       *sf,		// I - Localization strings or `NULL` for the default
+             const char **keys,		// I - Key strings
+             size_t     num_keys,	// I - Number of key strings
+             const char **texts)	// O - Localized strings
+{
+  size_t	i, j,			// Looping vars
+		count,			// Number of keys in batch
+		found = 0,		// Number of localized strings found
+		lookups = 0,		// Number of lookups
+		filtered = 0,		// Number of misses rejected by the filter
+		false_positives = 0;	// Number of misses that passed the filter
+  _sf_pair_t	*matches[_SF_BATCH];	// Matching pairs
+  bool		rejected[_SF_BATCH];	// Keys rejected by the filter
+
+
+  // Range check input...
+  if (!keys || !texts)
+    return (0);
+
+  if (!sf)
+    sf = _sfGetDefault();
+
+  if (!sf)
+  {
+    memmove(texts, keys, num_keys * sizeof(const char *));
+    return (0);
+  }
+
+  if (sf->shared)
+  {
+    // Shared catalogs are read-only and don't need a lock...
+    for (i = 0; i < num_keys; i ++)
+    {
+      if (keys[i] && (texts[i] = _sfGetShared(sf, keys[i])) != NULL)
+        found ++;
+      else
+        texts[i] = keys[i];
+
+      if (keys[i])
+        lookups ++;
+    }
+
+    if (sf->stats_enabled)
+      sf_add_stats(sf, lookups, found, 0, 0);
+
+    return (found);
+  }
+
+  // Look up the keys...
+  _sf_rwlock_rdlock(sf->rwlock);
+
+  if (sf->num_index && sf->num_index == sf->num_pairs)
+  {
+    for (i = 0; i < num_keys; i += count)
+    {
+      if ((count = num_keys - i) > _SF_BATCH)
+        count = _SF_BATCH;
+
+      found += sf_find_indexes(sf, keys + i, count, matches, rejected);
+
+      for (j = 0; j < count; j ++)
+      {
+        if (keys[i + j])
+          lookups ++;
+
+        if (matches[j])
+        {
+          texts[i + j] = matches[j]->text;
+        }
+        else if (sf->num_mos && keys[i + j] && (texts[i + j] = _sfGetMO(sf, keys[i + j])) != NULL)
+        {
+          found ++;
+        }
+        else
+        {
+          texts[i + j] = keys[i + j];
+
+          if (rejected[j])
+            filtered ++;
+          else if (keys[i + j])
+            false_positives ++;
+        }
+      }
+    }
+  }
+  else
+  {
+    for (i = 0; i < num_keys; i ++)
+    {
+      if (keys[i])
+        lookups ++;
+
+      if (keys[i] && (matches[0] = _sfFindPair(sf, keys[i])) != NULL)
+      {
+        texts[i] = matches[0]->text;
+        found ++;
+      }
+      else if (sf->num_mos && keys[i] && (texts[i] = _sfGetMO(sf, keys[i])) != NULL)
+      {
+        found ++;
+      }
+      else
+      {
+        texts[i] = keys[i];
+      }
+    }
+  }
+
+  _sf_rwlock_unlock(sf->rwlock);
+
+  if (sf->stats_enabled)
+    sf_add_stats(sf, lookups, found, filtered, false_positives);
+
+  return (found);
+}
+
+
 //
 // 'sfHasString()' - Determine whether a string is localized.
 //
@@ -247,7 +627,7 @@ bool					// O - `true` if the string exists, `false` otherwise
 sfHasString(sf_t       *sf,		// I - Localization strings
             const char *key)		// I - Key string
 {
-  _sf_pair_t	*match;			// Matching pair, if any
+  bool		found;			// Found the string?
 
 
   // Range check input...
@@ -257,12 +637,22 @@ sfHasString(sf_t       *sf,		// I - Localization strings
   if (!key || !sf)
     return (key);
 
+  if (sf->shared)
+  {
+    found = _sfGetShared(sf, key) != NULL;
+
+    if (sf->stats_enabled)
+      sf_add_stats(sf, 1, found, 0, 0);
+
+    return (found);
+  }
+
   // Look up the key...
   _sf_rwlock_rdlock(sf->rwlock);
-  match = _sfFindPair(sf, key);
+  found = sf_lookup(sf, key) != NULL;
   _sf_rwlock_unlock(sf->rwlock);
 
-  return (match != NULL);
+  return (found);
 }
 
 
@@ -380,6 +770,12 @@ sfLoadString(sf_t       *sf,		// I - Localization strings
     return (false);
   }
 
+  if (sf->shared)
+  {
+    _sfSetError(sf, "Shared catalogs cannot be modified.");
+    return (false);
+  }
+
   _sf_rwlock_wrlock(sf->rwlock);
 
   // Scan the in-memory strings data and add key/text pairs...
@@ -627,6 +1023,110 @@ sfLoadString(sf_t       *sf,		// I - Localization strings
 }
 
 
+//
+// '_sfMergePairs()' - Merge the pairs from another strings file.
+//
+// Both collections must be sorted.  Pairs that are only in "msf" are moved to
+// "sf", and pairs that are only in "sf" are removed when "clean" is `true`.
+// The merged pairs are built in a single pass over both arrays, and "msf" is
+// left empty.
+//
+
+bool					// O - `true` on success, `false` on error
+_sfMergePairs(sf_t *sf,			// I - Localization strings
+              sf_t *msf,		// I - Strings to merge
+              bool clean,		// I - Remove pairs that are not in "msf"?
+              int  *added,		// O - Number of added pairs
+              int  *removed)		// O - Number of removed pairs
+{
+  _sf_pair_t	*pairs,			// Merged pairs
+		*pair,			// Current merged pair
+		*spair,			// Current pair in "sf"
+		*send,			// End of pairs in "sf"
+		*mpair,			// Current pair in "msf"
+		*mend;			// End of pairs in "msf"
+  size_t	alloc;			// Number of allocated pairs
+  int		result;			// Result of comparison
+
+
+  *added   = 0;
+  *removed = 0;
+
+  if (sf->need_sort)
+    sf_sort(sf);
+
+  if (msf->need_sort)
+    sf_sort(msf);
+
+  alloc = sf->num_pairs + msf->num_pairs + 1;
+
+  if ((pairs = malloc(alloc * sizeof(_sf_pair_t))) == NULL)
+  {
+    _sfSetError(sf, "Unable to allocate memory for pairs.");
+    return (false);
+  }
+
+  for (pair = pairs, spair = sf->pairs, send = spair + sf->num_pairs, mpair = msf->pairs, mend = mpair + msf->num_pairs; spair < send || mpair < mend;)
+  {
+    if (spair >= send)
+      result = 1;
+    else if (mpair >= mend)
+      result = -1;
+    else
+      result = strcmp(spair->key, mpair->key);
+
+    if (result < 0)
+    {
+      // Pair is only in "sf"...
+      if (clean)
+      {
+        sf_free_pair(spair);
+        (*removed) ++;
+      }
+      else
+      {
+        *pair++ = *spair;
+      }
+
+      spair ++;
+    }
+    else if (result > 0)
+    {
+      // Pair is only in "msf"...
+      *pair++ = *mpair;
+      memset(mpair, 0, sizeof(_sf_pair_t));
+      (*added) ++;
+
+      mpair ++;
+    }
+    else
+    {
+      // Pair is in both...
+      *pair++ = *spair++;
+      mpair ++;
+    }
+  }
+
+  free(sf->pairs);
+
+  sf->pairs       = pairs;
+  sf->num_pairs   = (size_t)(pair - pairs);
+  sf->alloc_pairs = alloc;
+
+  sf_update_index(sf);
+
+  // Free what is left in "msf"...
+  for (mpair = msf->pairs; mpair < mend; mpair ++)
+    sf_free_pair(mpair);
+
+  msf->num_pairs = 0;
+
+  sf_update_index(msf);
+
+  return (true);
+}
+
+
 //
 // 'sfNew()' - Create a new (empty) set of localization strings.
 //
@@ -664,6 +1164,7 @@ _sfRemovePair(sf_t       *sf,		// I - Localization strings
   sf_free_pair(pair);
 
   sf->num_pairs --;
+  sf->num_index = 0;
 
   if (n < sf->num_pairs)
     memmove(sf->pairs + n, sf->pairs + n + 1, (sf->num_pairs - n) * sizeof(_sf_pair_t));
@@ -683,6 +1184,12 @@ sfRemoveString(sf_t       *sf,		// I - Strings
   _sf_pair_t	*pair;			// Matching pair
 
 
+  if (sf->shared)
+  {
+    _sfSetError(sf, "Shared catalogs cannot be modified.");
+    return (false);
+  }
+
   _sf_rwlock_wrlock(sf->rwlock);
 
   if ((pair = _sfFindPair(sf, key)) != NULL)
@@ -712,6 +1219,127 @@ _sfSetError(sf_t       *sf,		// I - Localization strings
 }
 
 
+//
+// '_sfSortPairs()' - Sort the pairs after adding them with `_sfAddPair`.
+//
+
+void
+_sfSortPairs(sf_t *sf)			// I - Localization strings
+{
+  if (sf->need_sort)
+    sf_sort(sf);
+}
+
+
+//
+// 'sf_add_stats()' - Add to the lookup statistics.
+//
+
+static void
+sf_add_stats(sf_t   *sf,		// I - Localization strings
+             size_t lookups,		// I - Number of lookups
+             size_t hits,		// I - Number of hits
+             size_t filtered,		// I - Number of misses rejected by the filter
+             size_t false_positives)	// I - Number of misses that passed the filter
+{
+  _sf_atomic_add(sf->stats.lookups, lookups);
+
+  if (hits)
+    _sf_atomic_add(sf->stats.hits, hits);
+  if (filtered)
+    _sf_atomic_add(sf->stats.filtered, filtered);
+  if (false_positives)
+    _sf_atomic_add(sf->stats.false_positives, false_positives);
+}
+
+
+//
+// 'sf_build_index()' - Fill the search index from the sorted pairs.
+//
+// The index is a complete binary search tree stored in breadth-first
+// (Eytzinger) order, so the first levels of every search share the same few
+// cache lines and the children of node "k" are nodes "2k" and "2k+1".  Node 0
+// only holds the length of the prefix shared by all keys.
+//
+
+static size_t				// O - Next pair number
+sf_build_index(sf_t   *sf,		// I - Localization strings
+               size_t i,		// I - Next pair number
+               size_t k)		// I - Index node
+{
+  if (k <= sf->num_pairs)
+  {
+    i = sf_build_index(sf, i, 2 * k);
+
+    sf->index[k].pair = (uint32_t)i;
+    i ++;
+
+    i = sf_build_index(sf, i, 2 * k + 1);
+  }
+
+  return (i);
+}
+
+
+//
+// 'sf_build_skip()' - Compute the common prefix lengths for the search index.
+//
+// Every key that can reach node "k" lies between the keys of pair numbers "lo"
+// and "hi", so it shares their common prefix and the node only needs to store
+// the key bytes that follow it.  A bound of `SIZE_MAX` means there is no bound
+// on that side, in which case the prefix shared by all keys is used.
+//
+
+static void
+sf_build_skip(sf_t   *sf,		// I - Localization strings
+              size_t k,			// I - Index node
+              size_t lo,		// I - Lower bound pair number or `SIZE_MAX`
+              size_t hi)		// I - Upper bound pair number or `SIZE_MAX`
+{
+  const char	*lokey,			// Lower bound key
+		*hikey;			// Upper bound key
+  _sf_index_t	*node;			// Current node
+
+
+  if (k > sf->num_pairs)
+    return;
+
+  node = sf->index + k;
+
+  if (lo == SIZE_MAX || hi == SIZE_MAX)
+  {
+    node->skip = sf->index[0].skip;
+  }
+  else
+  {
+    for (lokey = sf->pairs[lo].key, hikey = sf->pairs[hi].key; *lokey && *lokey == *hikey; lokey ++, hikey ++);
+
+    node->skip = (uint32_t)(lokey - sf->pairs[lo].key);
+  }
+
+  node->prefix = sf_key_prefix(sf->pairs[node->pair].key + node->skip);
+
+  sf_build_skip(sf, 2 * k, lo, node->pair);
+  sf_build_skip(sf, 2 * k + 1, node->pair, hi);
+}
+
+
+//
+// 'sf_check_filter()' - Check whether a key hash may be in the filter.
+//
+
+static bool				// O - `true` if the key may be present, `false` if not
+sf_check_filter(sf_t     *sf,		// I - Localization strings
+                uint64_t hash)		// I - Key hash
+{
+  uint64_t	bits = sf_word_filter(hash);
+					// Bits for key
+
+
+  return ((sf->filter[hash & sf->filter_mask] & bits) == bits);
+}
+
+
 //
 // 'sf_compare_pairs()' - Compare the keys of two key/text pairs.
 //
@@ -724,6 +1352,102 @@ sf_compare_pairs(_sf_pair_t *a,		// I - First key/text pair
 }
 
 
+//
+// 'sf_find_index()' - Find a pair using the search index.
+//
+
+static _sf_pair_t *			// O - Matching pair or `NULL`
+sf_find_index(sf_t       *sf,		// I - Localization strings
+              const char *key)		// I - Key string
+{
+  _sf_pair_t	*match = NULL;		// Matching pair
+  size_t	k;			// Current node number
+
+
+  // Keys without the prefix shared by all keys cannot match...
+  if (strncmp(key, sf->pairs[0].key, sf->index[0].skip))
+    return (NULL);
+
+  for (k = 1; k; k = sf_step_index(sf, key, k, &match));
+
+  return (match);
+}
+
+
+//
+// 'sf_find_indexes()' - Find a batch of pairs using the search index.
+//
+// The searches for up to `_SF_BATCH` keys are interleaved one level at a time,
+// with a prefetch of each key's next node, so that the memory accesses for all
+// of the keys are overlapped instead of waiting on each one in turn.
+//
+
+static size_t				// O - Number of matching pairs
+sf_find_indexes(sf_t       *sf,		// I - Localization strings
+                const char **keys,	// I - Key strings
+                size_t     num_keys,	// I - Number of keys (up to `_SF_BATCH`)
+                _sf_pair_t **matches,	// O - Matching pairs or `NULL`
+                bool       *filtered)	// O - `true` for keys rejected by the filter
+{
+  size_t	i,			// Looping var
+		active = 0,		// Number of active searches
+		found = 0,		// Number of matching pairs
+		k[_SF_BATCH];		// Current node numbers
+  uint64_t	hashes[_SF_BATCH];	// Key hashes
+
+
+  // Hash all of the keys and fetch their filter words...
+  for (i = 0; i < num_keys; i ++)
+  {
+    hashes[i] = keys[i] ? sf_hash_key(keys[i]) : 0;
+    _sf_prefetch(sf->filter + (hashes[i] & sf->filter_mask));
+  }
+
+  // Start the searches for the keys that pass the filter...
+  for (i = 0; i < num_keys; i ++)
+  {
+    matches[i]  = NULL;
+    filtered[i] = false;
+    k[i]        = 0;
+
+    if (!keys[i])
+      continue;
+
+    if (!sf_check_filter(sf, hashes[i]))
+    {
+      filtered[i] = true;
+    }
+    else if (!strncmp(keys[i], sf->pairs[0].key, sf->index[0].skip))
+    {
+      k[i] = 1;
+      active ++;
+
+      _sf_prefetch(sf->index + 1);
+    }
+  }
+
+  // Then step each search until they are all done...
+  while (active > 0)
+  {
+    for (i = 0; i < num_keys; i ++)
+    {
+      if (!k[i])
+        continue;
+
+      if ((k[i] = sf_step_index(sf, keys[i], k[i], matches + i)) == 0)
+      {
+        active --;
+
+        if (matches[i])
+          found ++;
+      }
+    }
+  }
+
+  return (found);
+}
+
+
 //
 // 'sf_free_pair()' - Free memory used by a key/text pair.
 //
@@ -734,17 +1458,228 @@ sf_free_pair(_sf_pair_t *pair)		// I - Pair
   free(pair->key);
   free(pair->text);
   free(pair->comment);
+  free(pair->format);
+}
+
+
+//
+// 'sf_hash_key()' - Compute a 64-bit hash of a key.
+//
+// This is FNV-1a followed by the MurmurHash3 finalizer so that all of the bits
+// are usable by the filter.
+//
+
+static uint64_t				// O - Hash value
+sf_hash_key(const char *key)		// I - Key string
+{
+  uint64_t	hash = 0xcbf29ce484222325ULL;
+					// Hash value
+
+
+  while (*key)
+  {
+    hash ^= (unsigned char)*key++;
+    hash *= 0x100000001b3ULL;
+  }
+
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+
+  return (hash);
 }
 
 
 //
-// 'sf_sort()' - Sort the strings.
+// 'sf_key_prefix()' - Get the first 8 bytes of a key as a big-endian number.
+//
+// Shorter keys are padded with 0 bytes, so the low byte is 0 for any key that
+// is less than 8 bytes long.
+//
+
+static uint64_t				// O - Key prefix
+sf_key_prefix(const char *key)		// I - Key string
+{
+  uint64_t	prefix = 0;		// Key prefix
+  int		i;			// Looping var
+
+
+  for (i = 0; i < 8; i ++)
+  {
+    prefix <<= 8;
+
+    if (*key)
+      prefix |= (unsigned char)*key++;
+  }
+
+  return (prefix);
+}
+
+
+//
+// 'sf_step_index()' - Compare a key to an index node and pick the next node.
+//
+// Each node holds the 8 key bytes that follow the prefix shared by every key
+// that can reach it, so most steps are resolved by comparing two numbers in
+// the index without touching the key strings.
+//
+
+static size_t				// O - Next node number or 0 when done
+sf_step_index(sf_t       *sf,		// I  - Localization strings
+              const char *key,		// I  - Key string
+              size_t     k,		// I  - Current node number
+              _sf_pair_t **match)	// IO - Matching pair
+{
+  _sf_index_t	*node = sf->index + k;	// Current node
+  uint64_t	prefix;			// Key prefix
+  int		result;			// Result of comparison
+
+
+  if ((prefix = sf_key_prefix(key + node->skip)) == node->prefix)
+  {
+    // Same prefix, compare the rest of the key as needed...
+    if (!(prefix & 255) || (result = strcmp(key + node->skip + 8, sf->pairs[node->pair].key + node->skip + 8)) == 0)
+    {
+      *match = sf->pairs + node->pair;
+      return (0);
+    }
+  }
+  else
+  {
+    result = prefix < node->prefix ? -1 : 1;
+  }
+
+  if ((k = 2 * k + (result > 0)) > sf->num_index)
+    return (0);
+
+  // Fetch the next node and the cache line holding its grandchildren...
+  _sf_prefetch(sf->index + k);
+  _sf_prefetch(sf->index + 4 * k);
+
+  return (k);
+}
+
+
+//
+// 'sf_lookup()' - Look up a localized string for the public functions.
+//
+// The pairs are searched first, then any message catalogs.  Statistics are
+// counted here rather than in @link _sfFindPair@ so that the lookups made while
+// loading and merging strings are not included.  The caller must hold the read
+// lock.
+//
+
+static const char *			// O - Localized text or `NULL` if not found
+sf_lookup(sf_t       *sf,		// I - Localization strings
+          const char *key)		// I - Key string
+{
+  _sf_pair_t	*match = NULL;		// Matching pair
+  const char	*s = NULL;		// Localized text
+  bool		indexed = sf->num_index && sf->num_index == sf->num_pairs,
+					// Use the filter and search index?
+		filtered = false;	// Rejected by the filter?
+
+
+  if (!indexed)
+    match = _sfFindPair(sf, key);
+  else if (sf_check_filter(sf, sf_hash_key(key)))
+    match = sf_find_index(sf, key);
+  else
+    filtered = true;
+
+  if (match)
+    s = match->text;
+  else if (sf->num_mos)
+    s = _sfGetMO(sf, key);
+
+  if (sf->stats_enabled)
+    sf_add_stats(sf, 1, s != NULL, !s && filtered, !s && indexed && !filtered);
+
+  return (s);
+}
+
+
+//
+// 'sf_sort()' - Sort the strings and rebuild the search index.
 //
 
 static void
 sf_sort(sf_t *sf)			// I - Localization strings
 {
   qsort(sf->pairs, sf->num_pairs, sizeof(_sf_pair_t), (int (*)(const void *, const void *))sf_compare_pairs);
+
+  sf_update_index(sf);
+}
+
+
+//
+// 'sf_update_index()' - Rebuild the search index and filter for sorted pairs.
+//
+
+static void
+sf_update_index(sf_t *sf)		// I - Localization strings
+{
+  const char	*first,			// Pointer into first key
+		*last;			// Pointer into last key
+  _sf_pair_t	*pair;			// Current pair
+  size_t	count,			// Number of pairs remaining
+		num_words;		// Number of filter words
+  uint64_t	hash;			// Key hash
+
+
   sf->need_sort = false;
+
+  // Rebuild the search index and filter, aligning the nodes to a cache
+  // line.  The filter uses one 64-bit word per key with 16 to 32 bits per
+  // key, for a false positive rate of about 1%...
+  free(sf->index_data);
+
+  sf->num_index   = 0;
+  sf->index_data  = NULL;
+  sf->index       = NULL;
+  sf->filter      = NULL;
+  sf->filter_mask = 0;
+
+  if (sf->num_pairs == 0 || sf->num_pairs > UINT32_MAX)
+    return;
+
+  for (num_words = 1; num_words < (sf->num_pairs / 4); num_words *= 2);
+
+  if ((sf->index_data = calloc(1, (sf->num_pairs + 5) * sizeof(_sf_index_t) + num_words * sizeof(uint64_t))) == NULL)
+    return;				// Fall back on bsearch
+
+  sf->index       = (_sf_index_t *)(((uintptr_t)sf->index_data + 63) & ~(uintptr_t)63);
+  sf->filter      = (uint64_t *)(sf->index + sf->num_pairs + 1);
+  sf->filter_mask = num_words - 1;
+
+  for (count = sf->num_pairs, pair = sf->pairs; count > 0; count --, pair ++)
+  {
+    hash = sf_hash_key(pair->key);
+    sf->filter[hash & sf->filter_mask] |= sf_word_filter(hash);
+  }
+
+  for (first = sf->pairs[0].key, last = sf->pairs[sf->num_pairs - 1].key; *first && *first == *last; first ++, last ++);
+
+  sf->index[0].skip = (uint32_t)(first - sf->pairs[0].key);
+
+  sf_build_index(sf, 0, 1);
+  sf_build_skip(sf, 1, SIZE_MAX, SIZE_MAX);
+
+  sf->num_index = sf->num_pairs;
 }
 
+
+//
+// 'sf_word_filter()' - Get the filter bits for a key hash.
+//
+// Four bits are set in the filter word using the high 24 bits of the hash; the
+// low bits of the hash select the word.
+//
+
+static uint64_t				// O - Filter bits
+sf_word_filter(uint64_t hash)		// I - Key hash
+{
+  return ((1ULL << ((hash >> 40) & 63)) | (1ULL << ((hash >> 46) & 63)) | (1ULL << ((hash >> 52) & 63)) | (1ULL << (hash >> 58)));
+}
@@ -0,0 +1,666 @@
+//
+// GNU gettext message catalog functions for StringsUtil.
+//
+// Copyright © 2026 by Michael R Sweet.
+//
+// Licensed under Apache License v2.0.  See the file "LICENSE" for more
+// information.
+//
+// A GNU gettext message catalog (".mo" file) has the following layout, with
+// all integers stored in the byte order of the system that created it:
+//
+//   uint32_t  magic;			// 0x950412de
+//   uint32_t  revision;		// Major revision in upper 16 bits
+//   uint32_t  num_strings;		// Number of strings
+//   uint32_t  originals;		// Offset of original string table
+//   uint32_t  translations;		// Offset of translation string table
+//   uint32_t  hash_size;		// Number of hash table slots
+//   uint32_t  hash;			// Offset of hash table
+//
+// Each string table entry is a length and offset pair, sorted by original
+// string.  Each hash table slot holds 0 for an empty slot or the string number
+// plus 1.  Plural translations are stored as nul-separated strings, so the
+// first string is the singular form.
+//
+
+#include "sf-private.h"
+
+
+//
+// Local functions...
+//
+
+static int	sf_compare_mopairs(_sf_pair_t *a, _sf_pair_t *b);
+static const char *sf_get_mostring(_sf_mo_t *mo, uint32_t table, uint32_t num);
+static uint32_t	sf_get_mouint(_sf_mo_t *mo, size_t offset);
+static uint32_t	sf_hash_mo(const char *key);
+static uint32_t	sf_next_prime(uint32_t n);
+
+
+//
+// '_sfCopyMO()' - Copy the strings in the loaded message catalogs to pairs.
+//
+// The catalog header (empty original) and message context entries ("CONTEXT"
+// followed by a 0x04 byte and the original) are skipped.
+//
+
+bool					// O - `true` on success, `false` on error
+_sfCopyMO(sf_t *sf)			// I - Localization strings
+{
+  size_t	i;			// Looping var
+  _sf_mo_t	*mo;			// Current message catalog
+  uint32_t	num;			// String number
+  const char	*key,			// Original string
+		*text;			// Translated string
+
+
+  for (i = sf->num_mos, mo = sf->mos; i > 0; i --, mo ++)
+  {
+    for (num = 0; num < mo->num_strings; num ++)
+    {
+      if ((key = sf_get_mostring(mo, mo->originals, num)) == NULL || (text = sf_get_mostring(mo, mo->translations, num)) == NULL)
+      {
+        _sfSetError(sf, "Invalid message catalog string %u.", (unsigned)num);
+        return (false);
+      }
+
+      if (*key && !strchr(key, '\004') && !_sfAddPair(sf, key, text, NULL))
+        return (false);
+    }
+  }
+
+  return (true);
+}
+
+
+//
+// '_sfGetMO()' - Look up a string in the loaded message catalogs.
+//
+
+const char *				// O - Localized text or `NULL` if not found
+_sfGetMO(sf_t       *sf,		// I - Localization strings
+         const char *key)		// I - Key string
+{
+  size_t	i;			// Looping var
+  _sf_mo_t	*mo;			// Current message catalog
+  uint32_t	hval,			// Hash value of key
+		idx,			// Current hash slot
+		incr,			// Hash slot increment
+		count,			// Number of slots probed
+		num,			// String number
+		left,			// Left side of search
+		right;			// Right side of search
+  const char	*original;		// Original string
+  int		result;			// Result of comparison
+
+
+  // The empty key is the catalog header and never localized...
+  if (!*key)
+    return (NULL);
+
+  hval = sf_hash_mo(key);
+
+  for (i = sf->num_mos, mo = sf->mos; i > 0; i --, mo ++)
+  {
+    if (mo->hash_size > 2)
+    {
+      // Use the hash table from the catalog...
+      idx  = hval % mo->hash_size;
+      incr = 1 + hval % (mo->hash_size - 2);
+
+      for (count = mo->hash_size; count > 0; count --)
+      {
+        if ((num = sf_get_mouint(mo, mo->hash + idx * 4)) == 0)
+          break;
+
+        num --;
+
+        if ((original = sf_get_mostring(mo, mo->originals, num)) != NULL && !strcmp(key, original))
+        {
+          if ((original = sf_get_mostring(mo, mo->translations, num)) == NULL)
+            break;
+
+          return (original);
+        }
+
+        if (idx >= mo->hash_size - incr)
+          idx -= mo->hash_size - incr;
+        else
+          idx += incr;
+      }
+    }
+    else
+    {
+      // No hash table, binary search the sorted original strings...
+      left  = 0;
+      right = mo->num_strings;
+
+      while (left < right)
+      {
+        num = (left + right) / 2;
+
+        if ((original = sf_get_mostring(mo, mo->originals, num)) == NULL)
+          break;			// Corrupt catalog
+
+        if ((result = strcmp(key, original)) == 0)
+        {
+          if ((original = sf_get_mostring(mo, mo->translations, num)) == NULL)
+            break;
+
+          return (original);
+        }
+        else if (result < 0)
+          right = num;
+        else
+          left = num + 1;
+      }
+    }
+  }
+
+  return (NULL);
+}
+
+
+//
+// '_sfMergeMO()' - Merge the pairs and message catalog strings.
+//
+// This function returns a sorted array with the pairs and the strings in the
+// loaded message catalogs that are not overridden by a pair or an earlier
+// catalog.  The array entries point to the original strings, so only the array
+// itself is freed.  The caller must hold a lock on the localization strings.
+//
+
+_sf_pair_t *				// O - Merged pairs or `NULL` on error
+_sfMergeMO(sf_t   *sf,			// I - Localization strings
+           size_t *num_pairs)		// O - Number of merged pairs
+{
+  _sf_pair_t	*pairs,			// Merged pairs
+		*pair;			// Current merged pair
+  size_t	i,			// Looping var
+		count;			// Number of merged pairs
+  _sf_mo_t	*mo;			// Current message catalog
+  uint32_t	num;			// String number
+  const char	*key,			// Original string
+		*text;			// Translated string
+
+
+  // Allocate enough room for every pair and catalog string...
+  for (i = sf->num_mos, mo = sf->mos, count = sf->num_pairs; i > 0; i --, mo ++)
+    count += mo->num_strings;
+
+  if ((pairs = calloc(count + 1, sizeof(_sf_pair_t))) == NULL)
+  {
+    _sfSetError(sf, "Unable to allocate memory for pairs.");
+    return (NULL);
+  }
+
+  if (sf->num_pairs > 0)
+    memcpy(pairs, sf->pairs, sf->num_pairs * sizeof(_sf_pair_t));
+
+  // Add the catalog strings that are used for lookups, skipping the header and
+  // message context entries...
+  for (i = sf->num_mos, mo = sf->mos, pair = pairs + sf->num_pairs; i > 0; i --, mo ++)
+  {
+    for (num = 0; num < mo->num_strings; num ++)
+    {
+      if ((key = sf_get_mostring(mo, mo->originals, num)) == NULL || (text = sf_get_mostring(mo, mo->translations, num)) == NULL)
+      {
+        _sfSetError(sf, "Invalid message catalog string %u.", (unsigned)num);
+        free(pairs);
+        return (NULL);
+      }
+
+      if (!*key || strchr(key, '\004') || _sfFindPair(sf, key) || _sfGetMO(sf, key) != text)
+        continue;
+
+      pair->key  = (char *)key;
+      pair->text = (char *)text;
+      pair ++;
+    }
+  }
+
+  *num_pairs = (size_t)(pair - pairs);
+
+  if (*num_pairs > sf->num_pairs)
+    qsort(pairs, *num_pairs, sizeof(_sf_pair_t), (int (*)(const void *, const void *))sf_compare_mopairs);
+
+  return (pairs);
+}
+
+
+//
+// 'sfLoadMO()' - Load a GNU gettext ".mo" file.
+//
+// This function maps a compiled GNU gettext message catalog (".mo" file) into
+// memory.  Lookups using @link sfGetString@ and @link sfHasString@ use the hash
+// table stored in the file, so no memory is allocated for the individual
+// strings.  Strings added with @link sfAddString@ or loaded from ".strings"
+// files take precedence over strings in message catalogs, and message catalogs
+// are searched in the order they were loaded.
+//
+// Message context ("msgctxt") entries are not supported, and only the singular
+// form of plural translations is used.
+//
+
+bool					// O - `true` on success, `false` on error
+sfLoadMO(sf_t       *sf,		// I - Localization strings
+         const char *filename)		// I - ".mo" filename
+{
+  int		fd;			// File descriptor
+  struct stat	fileinfo;		// File information
+  char		*data;			// File data
+  _sf_mo_t	mo,			// Message catalog
+		*temp;			// New message catalogs
+
+
+  // Range check input...
+  if (!sf || !filename)
+  {
+    errno = EINVAL;
+    return (false);
+  }
+
+  if (sf->shared)
+  {
+    _sfSetError(sf, "Shared catalogs cannot be modified.");
+    return (false);
+  }
+
+  // Open and map the file...
+  if ((fd = open(filename, O_RDONLY)) < 0)
+  {
+    _sfSetError(sf, "Unable to open '%s': %s", filename, strerror(errno));
+    return (false);
+  }
+
+  if (fstat(fd, &fileinfo))
+  {
+    _sfSetError(sf, "Unable to get information for '%s': %s", filename, strerror(errno));
+    close(fd);
+    return (false);
+  }
+
+  if (fileinfo.st_size < 28 || (uint64_t)fileinfo.st_size > UINT32_MAX)
+  {
+    _sfSetError(sf, "Invalid message catalog '%s'.", filename);
+    close(fd);
+    return (false);
+  }
+
+#ifdef _WIN32
+  if ((data = malloc((size_t)fileinfo.st_size)) == NULL)
+  {
+    _sfSetError(sf, "Unable to allocate memory for '%s'.", filename);
+    close(fd);
+    return (false);
+  }
+
+  if (read(fd, data, (unsigned)fileinfo.st_size) != (int)fileinfo.st_size)
+  {
+    _sfSetError(sf, "Unable to read '%s': %s", filename, strerror(errno));
+    free(data);
+    close(fd);
+    return (false);
+  }
+
+#else
+  if ((data = mmap(NULL, (size_t)fileinfo.st_size, PROT_READ, MAP_SHARED, fd, 0)) == MAP_FAILED)
+  {
+    _sfSetError(sf, "Unable to map '%s': %s", filename, strerror(errno));
+    close(fd);
+    return (false);
+  }
+#endif // _WIN32
+
+  close(fd);
+
+  // Validate the header...
+  memset(&mo, 0, sizeof(mo));
+  mo.data = data;
+  mo.size = (size_t)fileinfo.st_size;
+
+  if (sf_get_mouint(&mo, 0) == 0xde120495)
+    mo.swap = true;			// Catalog uses the other byte order
+  else if (sf_get_mouint(&mo, 0) != 0x950412de)
+    goto invalid;
+
+  mo.num_strings  = sf_get_mouint(&mo, 8);
+  mo.originals    = sf_get_mouint(&mo, 12);
+  mo.translations = sf_get_mouint(&mo, 16);
+  mo.hash_size    = sf_get_mouint(&mo, 20);
+  mo.hash         = sf_get_mouint(&mo, 24);
+
+  if ((sf_get_mouint(&mo, 4) >> 16) > 1 || mo.num_strings > mo.size / 8 || mo.originals > mo.size - mo.num_strings * 8 || mo.translations > mo.size - mo.num_strings * 8 || mo.hash_size > mo.size / 4 || mo.hash > mo.size - mo.hash_size * 4)
+    goto invalid;
+
+  // Add the catalog...
+  _sf_rwlock_wrlock(sf->rwlock);
+
+  if ((temp = realloc(sf->mos, (sf->num_mos + 1) * sizeof(_sf_mo_t))) == NULL)
+  {
+    _sf_rwlock_unlock(sf->rwlock);
+    _sfSetError(sf, "Unable to allocate memory for message catalog.");
+    goto error;
+  }
+
+  sf->mos = temp;
+  sf->mos[sf->num_mos ++] = mo;
+
+  _sf_rwlock_unlock(sf->rwlock);
+
+  return (true);
+
+  // If we get here the file is not a valid message catalog...
+  invalid:
+
+  _sfSetError(sf, "Invalid message catalog '%s'.", filename);
+
+  error:
+
+#ifdef _WIN32
+  free(data);
+#else
+  munmap(data, (size_t)fileinfo.st_size);
+#endif // _WIN32
+
+  return (false);
+}
+
+
+//
+// 'sfSaveMO()' - Save localization strings as a GNU gettext ".mo" file.
+//
+// This function writes the localization strings to a GNU gettext message
+// catalog that can be used by @link sfLoadMO@ or the GNU gettext library.  The
+// catalog includes a hash table for fast lookups.  Comments are not saved.  The
+// catalog is written to a temporary file and then renamed so that processes
+// never see a partial catalog.
+//
+
+bool					// O - `true` on success, `false` on error
+sfSaveMO(sf_t       *sf,		// I - Localization strings
+         const char *filename)		// I - ".mo" filename
+{
+  bool		ret = false;		// Return value
+  _sf_pair_t	*pair;			// Current pair
+  size_t	i,			// Looping var
+		num_strings,		// Number of strings
+		offset,			// Offset of current string
+		keylen,			// Length of key
+		textlen;		// Length of text
+  uint32_t	*tables = NULL,		// String and hash tables
+		*originals,		// Original string table
+		*translations,		// Translation string table
+		*hash,			// Hash table
+		hash_size,		// Number of hash table slots
+		hval,			// Hash value of key
+		idx,			// Current hash slot
+		incr,			// Hash slot increment
+		header[7];		// File header
+  const char	*key,			// Current key
+		*text;			// Current text
+  bool		need_header;		// Add a catalog header?
+  FILE		*fp;			// Output file
+  char		tempfile[1024];		// Temporary filename
+  static const char *content_type = "Content-Type: text/plain; charset=UTF-8\n";
+					// Catalog header
+
+
+  // Range check input...
+  if (!sf || !filename)
+  {
+    errno = EINVAL;
+    return (false);
+  }
+
+  if (sf->shared)
+  {
+    _sfSetError(sf, "Shared catalogs cannot be saved.");
+    return (false);
+  }
+
+  _sf_rwlock_wrlock(sf->rwlock);
+
+  _sfSortPairs(sf);
+
+  // GNU gettext gets the character set from the catalog header, which is the
+  // translation of the empty string...
+  need_header = sf->num_pairs == 0 || sf->pairs[0].key[0];
+  num_strings = sf->num_pairs + (need_header ? 1 : 0);
+
+  if (num_strings > (UINT32_MAX - 28) / 20)
+  {
+    _sfSetError(sf, "Too many strings for a message catalog.");
+    goto done;
+  }
+
+  // Allocate the string and hash tables, using the same size as msgfmt...
+  if ((hash_size = sf_next_prime((uint32_t)(num_strings * 4 / 3))) < 3)
+    hash_size = 3;
+
+  if ((tables = calloc(4 * num_strings + hash_size, sizeof(uint32_t))) == NULL)
+  {
+    _sfSetError(sf, "Unable to allocate memory for message catalog.");
+    goto done;
+  }
+
+  originals    = tables;
+  translations = originals + 2 * num_strings;
+  hash         = translations + 2 * num_strings;
+
+  // Write the strings after the tables in a single pass, then go back and
+  // write the header and tables...
+  snprintf(tempfile, sizeof(tempfile), "%s.%d", filename, (int)getpid());
+
+  if ((fp = fopen(tempfile, "wb")) == NULL)
+  {
+    _sfSetError(sf, "Unable to create '%s': %s", tempfile, strerror(errno));
+    goto done;
+  }
+
+  offset = 28 + (4 * num_strings + hash_size) * sizeof(uint32_t);
+
+  if (fseek(fp, (long)offset, SEEK_SET))
+    goto write_error;
+
+  for (i = 0, pair = sf->pairs; i < num_strings; i ++)
+  {
+    if (i == 0 && need_header)
+    {
+      key  = "";
+      text = content_type;
+    }
+    else
+    {
+      key  = pair->key;
+      text = pair->text;
+      pair ++;
+    }
+
+    keylen  = strlen(key);
+    textlen = strlen(text);
+
+    if ((offset + keylen + textlen + 2) > UINT32_MAX)
+    {
+      fclose(fp);
+      unlink(tempfile);
+      _sfSetError(sf, "Too many strings for a message catalog.");
+      goto done;
+    }
+
+    if (fwrite(key, 1, keylen + 1, fp) != (keylen + 1) || fwrite(text, 1, textlen + 1, fp) != (textlen + 1))
+      goto write_error;
+
+    originals[2 * i]        = (uint32_t)keylen;
+    originals[2 * i + 1]    = (uint32_t)offset;
+    translations[2 * i]     = (uint32_t)textlen;
+    translations[2 * i + 1] = (uint32_t)(offset + keylen + 1);
+
+    offset += keylen + textlen + 2;
+
+    // Add the string to the hash table...
+    hval = sf_hash_mo(key);
+    idx  = hval % hash_size;
+    incr = 1 + hval % (hash_size - 2);
+
+    while (hash[idx])
+    {
+      if (idx >= hash_size - incr)
+        idx -= hash_size - incr;
+      else
+        idx += incr;
+    }
+
+    hash[idx] = (uint32_t)(i + 1);
+  }
+
+  header[0] = 0x950412de;
+  header[1] = 0;
+  header[2] = (uint32_t)num_strings;
+  header[3] = 28;
+  header[4] = (uint32_t)(28 + 2 * num_strings * sizeof(uint32_t));
+  header[5] = hash_size;
+  header[6] = (uint32_t)(28 + 4 * num_strings * sizeof(uint32_t));
+
+  if (fseek(fp, 0, SEEK_SET) || fwrite(header, sizeof(header), 1, fp) != 1 || fwrite(tables, sizeof(uint32_t), 4 * num_strings + hash_size, fp) != (4 * num_strings + hash_size))
+    goto write_error;
+
+  if (fclose(fp))
+  {
+    _sfSetError(sf, "Unable to write '%s': %s", tempfile, strerror(errno));
+    unlink(tempfile);
+  }
+  else if (rename(tempfile, filename))
+  {
+    _sfSetError(sf, "Unable to rename '%s' to '%s': %s", tempfile, filename, strerror(errno));
+    unlink(tempfile);
+  }
+  else
+  {
+    ret = true;
+  }
+
+  goto done;
+
+  // If we get here there was a write error...
+  write_error:
+
+  _sfSetError(sf, "Unable to write '%s': %s", tempfile, strerror(errno));
+  fclose(fp);
+  unlink(tempfile);
+
+  done:
+
+  _sf_rwlock_unlock(sf->rwlock);
+
+  free(tables);
+
+  return (ret);
+}
+
+
+//
+// 'sf_compare_mopairs()' - Compare two merged pairs.
+//
+
+static int				// O - Result of comparison
+sf_compare_mopairs(_sf_pair_t *a,	// I - First pair
+                   _sf_pair_t *b)	// I - Second pair
+{
+  return (strcmp(a->key, b->key));
+}
+
+
+//
+// 'sf_get_mostring()' - Get a string from a message catalog table.
+//
+
+static const char *			// O - String or `NULL` if out of range
+sf_get_mostring(_sf_mo_t *mo,		// I - Message catalog
+                uint32_t table,		// I - Offset of string table
+                uint32_t num)		// I - String number
+{
+  uint32_t	length,			// Length of string
+		offset;			// Offset of string
+
+
+  if (num >= mo->num_strings)
+    return (NULL);
+
+  length = sf_get_mouint(mo, table + num * 8);
+  offset = sf_get_mouint(mo, table + num * 8 + 4);
+
+  if (offset >= mo->size || length >= mo->size - offset || mo->data[offset + length])
+    return (NULL);			// Not a nul-terminated string in the file
+
+  return (mo->data + offset);
+}
+
+
+//
+// 'sf_get_mouint()' - Get an integer from a message catalog.
+//
+
+static uint32_t				// O - Integer value
+sf_get_mouint(_sf_mo_t *mo,		// I - Message catalog
+              size_t   offset)		// I - Offset in file
+{
+  uint32_t	v;			// Integer value
+
+
+  memcpy(&v, mo->data + offset, sizeof(v));
+
+  if (mo->swap)
+    v = (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+
+  return (v);
+}
+
+
+//
+// 'sf_hash_mo()' - Compute the hash value of a key.
+//
+// This is the "hashpjw" function used by GNU gettext.
+//
+
+static uint32_t				// O - Hash value
+sf_hash_mo(const char *key)		// I - Key string
+{
+  uint32_t	hval,			// Hash value
+		g;			// High bits
+
+
+  for (hval = 0; *key; key ++)
+  {
+    hval <<= 4;
+    hval += (unsigned char)*key;
+
+    if ((g = hval & 0xf0000000) != 0)
+    {
+      hval ^= g >> 24;
+      hval ^= g;
+    }
+  }
+
+  return (hval);
+}
+
+
+//
+// 'sf_next_prime()' - Return the smallest odd prime number >= n.
+//
+
+static uint32_t				// O - Prime number
+sf_next_prime(uint32_t n)		// I - Minimum value
+{
+  uint32_t	d;			// Divisor
+
+
+  for (n |= 1;; n += 2)
+  {
+    for (d = 3; d <= n / d && n % d; d += 2);
+
+    if (d > n / d)
+      return (n);
+  }
+}
@@ -1,7 +1,7 @@
 //
 // Private strings file header file for StringsUtil.
 //
-// Copyright © 2022-2024 by Michael R Sweet.
+// Copyright © 2022-2026 by Michael R Sweet.
 //
 // Licensed under Apache License v2.0.  See the file "LICENSE" for more
 // information.
@@ -14,6 +14,7 @@
 #  include <string.h>
 #  include <ctype.h>
 #  include <errno.h>
+#  include <stdint.h>
 #  include <sys/stat.h>
 #  if _WIN32
 #    define _CRT_SECURE_NO_DEPRECATE
@@ -21,6 +22,8 @@
 #    include <io.h>
 #    include <process.h>
 typedef SRWLOCK _sf_rwlock_t;
+#    define _SF_RWLOCK_INITIALIZER	SRWLOCK_INIT
+#    define _SF_THREAD_LOCAL		__declspec(thread)
 #    define _sf_rwlock_destroy(rw)
 #    define _sf_rwlock_init(rw)		InitializeSRWLock(&rw)
 #    define _sf_rwlock_rdlock(rw)	AcquireSRWLockShared(&rw)
@@ -30,13 +33,28 @@ typedef SRWLOCK _sf_rwlock_t;
 #    include <unistd.h>
 #    include <fcntl.h>
 #    include <pthread.h>
+#    include <sys/mman.h>
 typedef pthread_rwlock_t _sf_rwlock_t;
+#    define _SF_RWLOCK_INITIALIZER	PTHREAD_RWLOCK_INITIALIZER
+#    define _SF_THREAD_LOCAL		__thread
 #    define _sf_rwlock_destroy(rw)	pthread_rwlock_destroy(&rw)
 #    define _sf_rwlock_init(rw)		pthread_rwlock_init(&rw, NULL)
 #    define _sf_rwlock_rdlock(rw)	pthread_rwlock_rdlock(&rw)
 #    define _sf_rwlock_wrlock(rw)	pthread_rwlock_wrlock(&rw)
 #    define _sf_rwlock_unlock(rw)	pthread_rwlock_unlock(&rw)
 #  endif // _WIN32
+#  if _WIN32
+#    define _sf_atomic_add(v,n)		InterlockedExchangeAddSizeT(&(v), (n))
+#    define _sf_atomic_get(v)		(*(volatile size_t *)&(v))
+#  else
+#    define _sf_atomic_add(v,n)		__atomic_fetch_add(&(v), (n), __ATOMIC_RELAXED)
+#    define _sf_atomic_get(v)		__atomic_load_n(&(v), __ATOMIC_RELAXED)
+#  endif // _WIN32
+#  if defined(__GNUC__) || defined(__clang__)
+#    define _sf_prefetch(addr)	__builtin_prefetch(addr)
+#  else
+#    define _sf_prefetch(addr)
+#  endif // __GNUC__ || __clang__
 #  include "sf.h"
 #  ifdef __cplusplus
 extern "C" {
@@ -51,9 +69,49 @@ typedef struct _sf_pair_s		// String pair
 {
   char		*key,			// Key string
 		*text,			// Localized text
-		*comment;		// Associated comment, if any
+		*comment,		// Associated comment, if any
+		*format;		// Format signature of key, if any
 } _sf_pair_t;
 
+typedef struct _sf_index_s		// Search index node
+{
+  uint64_t	prefix;			// Big-endian key bytes starting at "skip"
+  uint32_t	skip,			// Length of prefix common to the node's range
+		pair;			// Pair number
+} _sf_index_t;
+
+typedef struct _sf_mo_s		// GNU gettext message catalog
+{
+  const char	*data;			// Mapped file
+  size_t	size;			// Size of file
+  bool		swap;			// Swap byte order of integers?
+  uint32_t	num_strings,		// Number of strings
+		originals,		// Offset of original string table
+		translations,		// Offset of translation string table
+		hash_size,		// Number of hash table slots
+		hash;			// Offset of hash table
+} _sf_mo_t;
+
+typedef struct _sf_shpair_s		// String pair in a shared catalog
+{
+  uint32_t	key,			// Offset of key string
+		text,			// Offset of localized text
+		comment;		// Offset of comment or 0 for none
+} _sf_shpair_t;
+
+typedef struct _sf_shheader_s		// Shared catalog header
+{
+  char		magic[8];		// Magic string ("SFSHARE")
+  uint32_t	version,		// Layout version
+		num_pairs;		// Number of pairs
+  uint64_t	size;			// Total size of image in bytes
+} _sf_shheader_t;
+
+#  define _SF_BATCH	8		// Number of interleaved searches in a batch
+#  define _SF_MAX_FORMATS 100		// Maximum number of format arguments
+#  define _SF_SHMAGIC	"SFSHARE"	// Magic string for shared catalogs
+#  define _SF_SHVERSION	1		// Current shared catalog layout version
+
 struct _sf_s				// Strings file
 {
   _sf_rwlock_t	rwlock;			// Reader/writer lock
@@ -61,6 +119,17 @@ struct _sf_s				// Strings file
   size_t	num_pairs,		// Number of pairs
 		alloc_pairs;		// Allocated pairs
   _sf_pair_t	*pairs;			// Array of string pairs
+  size_t	num_index;		// Number of nodes in search index
+  void		*index_data;		// Search index and filter allocation
+  _sf_index_t	*index;			// Search index in Eytzinger order
+  size_t	filter_mask;		// Mask for filter word numbers
+  uint64_t	*filter;		// Bloom filter of keys
+  bool		stats_enabled;		// Collect lookup statistics?
+  sf_stats_t	stats;			// Lookup statistics
+  const char	*shared;		// Shared catalog image, if any
+  size_t	shared_size;		// Size of shared catalog image
+  size_t	num_mos;		// Number of message catalogs
+  _sf_mo_t	*mos;			// Message catalogs
   char		error[256];		// Last error message
 };
 
@@ -70,10 +139,18 @@ struct _sf_s				// Strings file
 //
 
 extern _sf_pair_t	*_sfAddPair(sf_t *sf, const char *key, const char *text, const char *comment);
+extern bool		_sfCompileFormats(sf_t *sf);
+extern bool		_sfCopyMO(sf_t *sf);
 extern _sf_pair_t	*_sfFindPair(sf_t *sf, const char *key);
+extern bool		_sfFormatSignature(const char *s, char *sig, size_t sigsize);
 extern sf_t		*_sfGetDefault(void);
+extern const char	*_sfGetMO(sf_t *sf, const char *key);
+extern const char	*_sfGetShared(sf_t *sf, const char *key);
+extern _sf_pair_t	*_sfMergeMO(sf_t *sf, size_t *num_pairs);
+extern bool		_sfMergePairs(sf_t *sf, sf_t *msf, bool clean, int *added, int *removed);
 extern void		_sfRemovePair(sf_t *sf, _sf_pair_t *pair);
 extern void		_sfSetError(sf_t *sf, const char *message, ...) _SF_FORMAT(2,3);
+extern void		_sfSortPairs(sf_t *sf);
 
 
 #  ifdef __cplusplus
@@ -0,0 +1,322 @@
+//
+// Shared catalog functions for StringsUtil.
+//
+// Copyright © 2026 by Michael R Sweet.
+//
+// Licensed under Apache License v2.0.  See the file "LICENSE" for more
+// information.
+//
+// A shared catalog is a position-independent image of a collection of
+// localization strings that is written once and then mapped read-only by any
+// number of processes:
+//
+//   _sf_shheader_t   header;
+//   _sf_shpair_t     pairs[header.num_pairs];	// Sorted by key
+//   char             strings[];		// Nul-terminated strings
+//
+// All string references are byte offsets from the start of the image, and the
+// image always ends with a nul byte so that any in-range offset refers to a
+// terminated string.
+//
+
+#include "sf-private.h"
+
+
+//
+// Local functions...
+//
+
+static const _sf_shpair_t *sf_find_shpair(sf_t *sf, const char *key);
+
+
+//
+// 'sfAttachShared()' - Attach to a shared catalog.
+//
+// This function maps a shared catalog created by @link sfSaveShared@ into
+// memory read-only.  The pages of the catalog are shared by every process that
+// attaches to the same file, so a server with many worker processes only holds
+// one physical copy of the localization strings.  The file is typically stored
+// in "/dev/shm" or another memory-backed filesystem.
+//
+// The returned collection of localization strings cannot be modified, and
+// lookups using @link sfGetString@ and @link sfHasString@ do not take any locks.
+// Use @link sfDelete@ to detach from the shared catalog.
+//
+
+sf_t *					// O - Localization strings or `NULL` on error
+sfAttachShared(const char *filename)	// I - Shared catalog file
+{
+#ifdef _WIN32
+  (void)filename;
+
+  errno = ENOTSUP;
+
+  return (NULL);
+
+#else
+  sf_t			*sf;		// Localization strings
+  int			fd;		// File descriptor
+  struct stat		fileinfo;	// File information
+  void			*image;		// Mapped image
+  const _sf_shheader_t	*header;	// Image header
+
+
+  // Range check input...
+  if (!filename)
+  {
+    errno = EINVAL;
+    return (NULL);
+  }
+
+  // Open and map the file...
+  if ((fd = open(filename, O_RDONLY)) < 0)
+    return (NULL);
+
+  if (fstat(fd, &fileinfo))
+  {
+    close(fd);
+    return (NULL);
+  }
+
+  if ((size_t)fileinfo.st_size < sizeof(_sf_shheader_t))
+  {
+    close(fd);
+    errno = EINVAL;
+    return (NULL);
+  }
+
+  image = mmap(NULL, (size_t)fileinfo.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+  close(fd);
+
+  if (image == MAP_FAILED)
+    return (NULL);
+
+  // Validate the header...
+  header = (const _sf_shheader_t *)image;
+
+  if (memcmp(header->magic, _SF_SHMAGIC, sizeof(header->magic)) || header->version != _SF_SHVERSION || header->size != (uint64_t)fileinfo.st_size || header->num_pairs > ((size_t)fileinfo.st_size - sizeof(_sf_shheader_t)) / sizeof(_sf_shpair_t) || ((const char *)image)[fileinfo.st_size - 1])
+  {
+    munmap(image, (size_t)fileinfo.st_size);
+    errno = EINVAL;
+    return (NULL);
+  }
+
+  // Create the strings object...
+  if ((sf = sfNew()) == NULL)
+  {
+    munmap(image, (size_t)fileinfo.st_size);
+    return (NULL);
+  }
+
+  sf->shared      = (const char *)image;
+  sf->shared_size = (size_t)fileinfo.st_size;
+
+  return (sf);
+#endif // _WIN32
+}
+
+
+//
+// '_sfGetShared()' - Look up a string in a shared catalog.
+//
+
+const char *				// O - Localized text or `NULL` if not found
+_sfGetShared(sf_t       *sf,		// I - Localization strings
+             const char *key)		// I - Key string
+{
+  const _sf_shpair_t	*shpair;	// Matching pair
+
+
+  if ((shpair = sf_find_shpair(sf, key)) != NULL && shpair->text < sf->shared_size)
+    return (sf->shared + shpair->text);
+
+  return (NULL);
+}
+
+
+//
+// 'sfSaveShared()' - Save localization strings as a shared catalog.
+//
+// This function writes the localization strings to a shared catalog file that
+// can be mapped by other processes using @link sfAttachShared@.  Strings from
+// message catalogs loaded with @link sfLoadMO@ are included.  The catalog is
+// written to a temporary file and then renamed so that processes never see a
+// partial catalog.
+//
+
+bool					// O - `true` on success, `false` on error
+sfSaveShared(sf_t       *sf,		// I - Localization strings
+             const char *filename)	// I - Shared catalog file
+{
+  bool		ret = false;		// Return value
+  _sf_shheader_t *header;		// Image header
+  _sf_shpair_t	*shpair;		// Current shared pair
+  _sf_pair_t	*pairs = NULL,		// Pairs to save
+		*pair;			// Current pair
+  size_t	num_pairs,		// Number of pairs to save
+		count,			// Number of pairs remaining
+		size,			// Size of image
+		len;			// Length of string
+  char		*image,			// Image buffer
+		*strptr,		// Pointer into strings
+		tempfile[1024];		// Temporary filename
+  int		fd;			// File descriptor
+
+
+  // Range check input...
+  if (!sf || !filename)
+  {
+    errno = EINVAL;
+    return (false);
+  }
+
+  if (sf->shared)
+  {
+    _sfSetError(sf, "Shared catalogs cannot be saved.");
+    return (false);
+  }
+
+  _sf_rwlock_rdlock(sf->rwlock);
+
+  // Merge any message catalog strings with the pairs...
+  if (sf->num_mos > 0)
+  {
+    if ((pairs = _sfMergeMO(sf, &num_pairs)) == NULL)
+      goto done;
+  }
+  else
+  {
+    num_pairs = sf->num_pairs;
+  }
+
+  // Figure out how big the image is...
+  size = sizeof(_sf_shheader_t) + num_pairs * sizeof(_sf_shpair_t) + 1;
+
+  for (count = num_pairs, pair = pairs ? pairs : sf->pairs; count > 0; count --, pair ++)
+  {
+    size += strlen(pair->key) + strlen(pair->text) + 2;
+    if (pair->comment)
+      size += strlen(pair->comment) + 1;
+  }
+
+  if (size > UINT32_MAX)
+  {
+    _sfSetError(sf, "Too many strings for a shared catalog.");
+    goto done;
+  }
+
+  // Build the image...
+  if ((image = calloc(1, size)) == NULL)
+  {
+    _sfSetError(sf, "Unable to allocate %u bytes for shared catalog.", (unsigned)size);
+    goto done;
+  }
+
+  header = (_sf_shheader_t *)image;
+  memcpy(header->magic, _SF_SHMAGIC, sizeof(header->magic));
+  header->version   = _SF_SHVERSION;
+  header->num_pairs = (uint32_t)num_pairs;
+  header->size      = size;
+
+  shpair = (_sf_shpair_t *)(header + 1);
+  strptr = (char *)(shpair + num_pairs);
+
+  for (count = num_pairs, pair = pairs ? pairs : sf->pairs; count > 0; count --, pair ++, shpair ++)
+  {
+    len         = strlen(pair->key) + 1;
+    shpair->key = (uint32_t)(strptr - image);
+    memcpy(strptr, pair->key, len);
+    strptr += len;
+
+    len          = strlen(pair->text) + 1;
+    shpair->text = (uint32_t)(strptr - image);
+    memcpy(strptr, pair->text, len);
+    strptr += len;
+
+    if (pair->comment)
+    {
+      len             = strlen(pair->comment) + 1;
+      shpair->comment = (uint32_t)(strptr - image);
+      memcpy(strptr, pair->comment, len);
+      strptr += len;
+    }
+  }
+
+  // Write it to a temporary file and then move it into place...
+  snprintf(tempfile, sizeof(tempfile), "%s.%d", filename, (int)getpid());
+
+  if ((fd = open(tempfile, O_WRONLY | O_CREAT | O_TRUNC | O_EXCL, 0644)) < 0)
+  {
+    _sfSetError(sf, "Unable to create '%s': %s", tempfile, strerror(errno));
+  }
+  else if (write(fd, image, size) != (ssize_t)size)
+  {
+    _sfSetError(sf, "Unable to write '%s': %s", tempfile, strerror(errno));
+    close(fd);
+    unlink(tempfile);
+  }
+  else if (close(fd))
+  {
+    _sfSetError(sf, "Unable to write '%s': %s", tempfile, strerror(errno));
+    unlink(tempfile);
+  }
+  else if (rename(tempfile, filename))
+  {
+    _sfSetError(sf, "Unable to rename '%s' to '%s': %s", tempfile, filename, strerror(errno));
+    unlink(tempfile);
+  }
+  else
+  {
+    ret = true;
+  }
+
+  free(image);
+
+  done:
+
+  _sf_rwlock_unlock(sf->rwlock);
+
+  free(pairs);
+
+  return (ret);
+}
+
+
+//
+// 'sf_find_shpair()' - Find a pair in a shared catalog.
+//
+
+static const _sf_shpair_t *		// O - Matching pair or `NULL`
+sf_find_shpair(sf_t       *sf,		// I - Localization strings
+               const char *key)		// I - Key string
+{
+  const _sf_shheader_t	*header = (const _sf_shheader_t *)sf->shared;
+					// Image header
+  const _sf_shpair_t	*shpairs = (const _sf_shpair_t *)(header + 1);
+					// Sorted pairs
+  size_t		left = 0,	// Left side of search
+			right = header->num_pairs,
+					// Right side of search
+			current;	// Current pair
+  int			result;		// Result of comparison
+
+
+  // Binary search for the key...
+  while (left < right)
+  {
+    current = (left + right) / 2;
+
+    if (shpairs[current].key >= sf->shared_size)
+      return (NULL);			// Corrupt image
+
+    if ((result = strcmp(key, sf->shared + shpairs[current].key)) == 0)
+      return (shpairs + current);
+    else if (result < 0)
+      right = current;
+    else
+      left = current + 1;
+  }
+
+  return (NULL);
+}
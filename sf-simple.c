@@ -1,7 +1,7 @@
 //
 // Simple localization functions for StringsUtil.
 //
-// Copyright © 2022-2025 by Michael R Sweet.
+// Copyright © 2022-2026 by Michael R Sweet.
 //
 // Licensed under Apache License v2.0.  See the file "LICENSE" for more
 // information.
@@ -16,22 +16,160 @@
 #endif // _WIN32
 
 
+//
+// Local types...
+//
+
+typedef struct _sf_catalog_s		// Per-locale localization
+{
+  char		locale[8];		// Locale name
+  sf_t		*sf;			// Localization strings
+} _sf_catalog_t;
+
+typedef struct _sf_source_s		// Registered localization source
+{
+  const char	*locale,		// Locale for compiled-in string or `NULL`
+		*data;			// Compiled-in string or `NULL`
+  char		*directory;		// Directory of .strings files or `NULL`
+} _sf_source_t;
+
+
 //
 // Local globals...
 //
 
-static sf_t	*sf_default = NULL;	// Default localization
-static char	sf_locale[8] = "";	// Default locale
+static _sf_rwlock_t	sf_rwlock = _SF_RWLOCK_INITIALIZER;
+					// Lock for sources and catalogs
+static sf_t		*sf_default = NULL;
+					// Default localization
+static char		sf_locale[8] = "";
+					// Default locale
+static size_t		sf_num_catalogs = 0,
+					// Number of per-locale localizations
+			sf_num_sources = 0;
+					// Number of registered sources
+static _sf_catalog_t	*sf_catalogs = NULL;
+					// Per-locale localizations
+static _sf_source_t	*sf_sources = NULL;
+					// Registered sources
+static _SF_THREAD_LOCAL sf_t *sf_thread = NULL;
+					// Current thread's localization
+
+
+//
+// Local functions...
+//
+
+static void	sf_add_source(const char *locale, const char *data, const char *directory);
+static void	sf_copy_locale(char *dst, const char *src, size_t dstsize);
+static void	sf_load_directory(sf_t *sf, const char *locale, const char *directory);
+static bool	sf_match_locale(const char *locale, const char *match);
 
 
 //
 // '_sfGetDefault()' - Get the default localization, if any.
 //
+// The current thread's localization, as set by @link sfSetThreadLocale@, takes
+// precedence over the process-wide localization.
+//
 
 sf_t *					// O - Default localization or `NULL` if none
 _sfGetDefault(void)
 {
-  return (sf_default);
+  return (sf_thread ? sf_thread : sf_default);
+}
+
+
+//
+// 'sfGetLocale()' - Get the localization strings for a locale.
+//
+// This function returns the localization strings for the named locale, for
+// example "de" or "fr_CA".  The strings are loaded once from the sources
+// registered using @link sfRegisterString@ and @link sfRegisterDirectory@ and
+// then shared by all callers, so the returned pointer must not be freed using
+// @link sfDelete@.
+//
+// The returned localization strings are typically passed to
+// @link sfSetThreadLocale@ to select the language used by the current thread.
+//
+
+sf_t *					// O - Localization strings or `NULL` on error
+sfGetLocale(const char *locale)		// I - Locale name
+{
+  char		name[8];		// Locale name minus character set
+  size_t	i;			// Looping var
+  _sf_catalog_t	*catalog;		// Current catalog
+  _sf_source_t	*source;		// Current source
+  sf_t		*sf = NULL;		// Localization strings
+
+
+  // Range check input...
+  if (!locale || !*locale)
+    return (NULL);
+
+  sf_copy_locale(name, locale, sizeof(name));
+
+  // See if we already have the strings...
+  _sf_rwlock_rdlock(sf_rwlock);
+
+  if (sf_default && !strcmp(name, sf_locale))
+  {
+    sf = sf_default;
+  }
+  else
+  {
+    for (i = sf_num_catalogs, catalog = sf_catalogs; i > 0; i --, catalog ++)
+    {
+      if (!strcmp(name, catalog->locale))
+      {
+        sf = catalog->sf;
+        break;
+      }
+    }
+  }
+
+  _sf_rwlock_unlock(sf_rwlock);
+
+  if (sf)
+    return (sf);
+
+  // No, load them now, checking again in case another thread got here first...
+  _sf_rwlock_wrlock(sf_rwlock);
+
+  for (i = sf_num_catalogs, catalog = sf_catalogs; i > 0; i --, catalog ++)
+  {
+    if (!strcmp(name, catalog->locale))
+    {
+      sf = catalog->sf;
+      break;
+    }
+  }
+
+  if (!sf && (catalog = realloc(sf_catalogs, (sf_num_catalogs + 1) * sizeof(_sf_catalog_t))) != NULL)
+  {
+    sf_catalogs = catalog;
+
+    if ((sf = sfNew()) != NULL)
+    {
+      catalog += sf_num_catalogs;
+      sf_num_catalogs ++;
+
+      strncpy(catalog->locale, name, sizeof(catalog->locale));
+      catalog->sf = sf;
+
+      for (i = sf_num_sources, source = sf_sources; i > 0; i --, source ++)
+      {
+        if (source->directory)
+          sf_load_directory(sf, name, source->directory);
+        else if (sf_match_locale(source->locale, name))
+          sfLoadString(sf, source->data);
+      }
+    }
+  }
+
+  _sf_rwlock_unlock(sf_rwlock);
+
+  return (sf);
 }
 
 
@@ -53,7 +191,7 @@ sfPrintf(FILE       *fp,		// I - Output file
 
 
   va_start(ap, message);
-  vfprintf(fp, sfGetString(sf_default, message), ap);
+  vfprintf(fp, sfGetString(_sfGetDefault(), message), ap);
   putc('\n', fp);
   va_end(ap);
 }
@@ -72,7 +210,7 @@ void
 sfPuts(FILE       *fp,			// I - Output file
        const char *message)		// I - Message
 {
-  fputs(sfGetString(sf_default, message), fp);
+  fputs(sfGetString(_sfGetDefault(), message), fp);
   putc('\n', fp);
 }
 
@@ -81,25 +219,18 @@ sfPuts(FILE       *fp,			// I - Output file
 // 'sfRegisterDirectory()' - Register ".strings" files in a directory.
 //
 // This function registers ".strings" files in a directory.  You must call
-// @link sfSetLocale@ first to initialize the current locale.
+// @link sfSetLocale@ first to initialize the current locale.  The directory
+// is also used for localizations returned by @link sfGetLocale@.
+//
+// If the directory has no ".strings" file for a locale, a GNU gettext message
+// catalog named "LL_CC.mo" or "LL.mo" is loaded using @link sfLoadMO@ instead.
 //
 
 void
 sfRegisterDirectory(
     const char *directory)		// I - Directory of .strings files
 {
-  char	filename[1024];			// .strings filename
-
-
-  if (!sf_locale[0])
-    return;
-
-  snprintf(filename, sizeof(filename), "%s/%s.strings", directory, sf_locale);
-  if (!sfLoadFile(sf_default, filename))
-  {
-    snprintf(filename, sizeof(filename), "%s/%2s.strings", directory, sf_locale);
-    sfLoadFile(sf_default, filename);
-  }
+  sf_add_source(NULL, NULL, directory);
 }
 
 
@@ -107,18 +238,19 @@ sfRegisterDirectory(
 // 'sfRegisterString()' - Register a ".strings" file from a compiled-in string.
 //
 // This function registers a ".strings" file from a compiled-in string.  You
-// must call @link sfSetLocale@ first to initialize the current locale.
+// must call @link sfSetLocale@ first to initialize the current locale.  The
+// string is also used for localizations returned by @link sfGetLocale@, so it
+// must remain valid for the life of the program.
 //
 
 void
 sfRegisterString(const char *locale,	// I - Locale
                  const char *data)	// I - Strings data
 {
-  if (!sf_locale[0])
+  if (!locale || !data)
     return;
 
-  if (!strcmp(locale, sf_locale) || (strlen(locale) == 2 && !strncmp(locale, sf_locale, 2)))
-    sfLoadString(sf_default, data);
+  sf_add_source(locale, data, NULL);
 }
 
 
@@ -126,19 +258,25 @@ sfRegisterString(const char *locale,	// I - Locale
 // 'sfSetLocale()' - Set the current locale.
 //
 // This function calls `setlocale` to initialize the current locale based on
-// the current user session, and then creates an empty message catalog that is
-// filled by calls to @link sfRegisterDirectory@ and/or @link sfRegisterString@.
+// the current user session, and then creates a message catalog that is filled
+// by calls to @link sfRegisterDirectory@ and/or @link sfRegisterString@.
 //
 
 void
 sfSetLocale(void)
 {
-  char		*ptr;			// Pointer into locale name
+  size_t	count;			// Number of sources
+  _sf_source_t	*source;		// Current source
 
 
   // Only initialize once...
+  _sf_rwlock_wrlock(sf_rwlock);
+
   if (sf_default)
+  {
+    _sf_rwlock_unlock(sf_rwlock);
     return;
+  }
 
   // Create an empty strings file object...
   sf_default = sfNew();
@@ -180,9 +318,160 @@ sfSetLocale(void)
 #endif // _WIN32
 
   // Save the locale name minus the character set...
-  strncpy(sf_locale, locale, sizeof(sf_locale) - 1);
-  sf_locale[sizeof(sf_locale) - 1] = '\0';
+  sf_copy_locale(sf_locale, locale, sizeof(sf_locale));
+
+  // Load any sources that were registered before now...
+  for (count = sf_num_sources, source = sf_sources; count > 0; count --, source ++)
+  {
+    if (source->directory)
+      sf_load_directory(sf_default, sf_locale, source->directory);
+    else if (sf_match_locale(source->locale, sf_locale))
+      sfLoadString(sf_default, source->data);
+  }
+
+  _sf_rwlock_unlock(sf_rwlock);
+}
+
+
+//
+// 'sfSetThreadLocale()' - Set the localization strings for the current thread.
+//
+// This function sets the localization strings used by the current thread for
+// @link sfPrintf@, @link sfPuts@, and the other functions when the default
+// localization strings ("sf" passed as `NULL`) are used.  Typically the
+// localization strings are obtained using @link sfGetLocale@.  Pass `NULL` to
+// revert to the process-wide localization set up by @link sfSetLocale@.
+//
+// Changing the thread's localization does not take any locks, so a thread can
+// cheaply switch languages for each request it handles.
+//
+
+sf_t *					// O - Previous localization strings for the thread
+sfSetThreadLocale(sf_t *sf)		// I - Localization strings or `NULL` for the default
+{
+  sf_t	*prev = sf_thread;		// Previous localization strings
+
+
+  sf_thread = sf;
+
+  return (prev);
+}
+
+
+//
+// 'sf_add_source()' - Add a registered localization source.
+//
+// The source is loaded immediately into the process-wide and any existing
+// per-locale localizations that match.
+//
+
+static void
+sf_add_source(const char *locale,	// I - Locale of compiled-in string or `NULL`
+              const char *data,		// I - Compiled-in string or `NULL`
+              const char *directory)	// I - Directory or `NULL`
+{
+  size_t	i;			// Looping var
+  _sf_source_t	*source;		// New source
+  _sf_catalog_t	*catalog;		// Current catalog
+
+
+  _sf_rwlock_wrlock(sf_rwlock);
+
+  if ((source = realloc(sf_sources, (sf_num_sources + 1) * sizeof(_sf_source_t))) != NULL)
+  {
+    sf_sources = source;
+    source     += sf_num_sources;
+
+    source->locale    = locale;
+    source->data      = data;
+    source->directory = directory ? strdup(directory) : NULL;
+
+    if (!directory || source->directory)
+      sf_num_sources ++;
+  }
+
+  // Load the strings...
+  if (directory)
+  {
+    if (sf_locale[0])
+      sf_load_directory(sf_default, sf_locale, directory);
+
+    for (i = sf_num_catalogs, catalog = sf_catalogs; i > 0; i --, catalog ++)
+      sf_load_directory(catalog->sf, catalog->locale, directory);
+  }
+  else
+  {
+    if (sf_locale[0] && sf_match_locale(locale, sf_locale))
+      sfLoadString(sf_default, data);
+
+    for (i = sf_num_catalogs, catalog = sf_catalogs; i > 0; i --, catalog ++)
+    {
+      if (sf_match_locale(locale, catalog->locale))
+        sfLoadString(catalog->sf, data);
+    }
+  }
+
+  _sf_rwlock_unlock(sf_rwlock);
+}
 
-  if ((ptr = strchr(sf_locale, '.')) != NULL)
+
+//
+// 'sf_copy_locale()' - Copy a locale name minus the character set.
+//
+
+static void
+sf_copy_locale(char       *dst,		// I - Destination buffer
+               const char *src,		// I - Locale name
+               size_t     dstsize)	// I - Size of destination buffer
+{
+  char	*ptr;				// Pointer into locale name
+
+
+  strncpy(dst, src, dstsize - 1);
+  dst[dstsize - 1] = '\0';
+
+  if ((ptr = strchr(dst, '.')) != NULL)
     *ptr = '\0';
 }
+
+
+//
+// 'sf_load_directory()' - Load the ".strings" or ".mo" file for a locale from a directory.
+//
+
+static void
+sf_load_directory(sf_t       *sf,	// I - Localization strings
+                  const char *locale,	// I - Locale name
+                  const char *directory)// I - Directory of .strings files
+{
+  char	filename[1024];			// .strings filename
+
+
+  snprintf(filename, sizeof(filename), "%s/%s.strings", directory, locale);
+  if (sfLoadFile(sf, filename))
+    return;
+
+  snprintf(filename, sizeof(filename), "%s/%.2s.strings", directory, locale);
+  if (sfLoadFile(sf, filename))
+    return;
+
+  // No .strings file, try a GNU gettext message catalog...
+  snprintf(filename, sizeof(filename), "%s/%s.mo", directory, locale);
+  if (!sfLoadMO(sf, filename))
+  {
+    snprintf(filename, sizeof(filename), "%s/%.2s.mo", directory, locale);
+    sfLoadMO(sf, filename);
+  }
+}
+
+
+//
+// 'sf_match_locale()' - Determine whether a registered locale matches.
+//
+
+static bool				// O - `true` if the locale matches, `false` otherwise
+sf_match_locale(const char *locale,	// I - Registered locale
+                const char *match)	// I - Locale to match
+{
+  return (!strcmp(locale, match) || (strlen(locale) == 2 && !strncmp(locale, match, 2)));
+}
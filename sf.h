@@ -1,7 +1,7 @@
 //
 // Public header file for StringsUtil.
 //
-// Copyright © 2022 by Michael R Sweet.
+// Copyright © 2022-2026 by Michael R Sweet.
 //
 // Licensed under Apache License v2.0.  See the file "LICENSE" for more
 // information.
@@ -35,18 +35,32 @@ extern "C" {
 
 typedef struct _sf_s	sf_t;		// Strings file
 
+typedef struct sf_stats_s		// Lookup statistics
+{
+  size_t	lookups,		// Number of lookups
+		hits,			// Number of lookups that found a string
+		filtered,		// Number of misses rejected by the filter
+		false_positives;	// Number of misses that passed the filter
+} sf_stats_t;
+
 
 //
 // Functions...
 //
 
 extern bool		sfAddString(sf_t *sf, const char *key, const char *text, const char *comment);
+extern sf_t		*sfAttachShared(const char *filename);
 extern void		sfDelete(sf_t *sf);
+extern void		sfEnableStats(sf_t *sf, bool enable);
 extern const char	*sfFormatString(sf_t *sf, char *buffer, size_t bufsize, const char *key, ...) _SF_FORMAT(4,5);
 extern const char	*sfGetError(sf_t *sf);
+extern sf_t		*sfGetLocale(const char *locale);
+extern void		sfGetStats(sf_t *sf, sf_stats_t *stats);
 extern const char	*sfGetString(sf_t *sf, const char *key);
+extern size_t		sfGetStrings(sf_t *sf, const char **keys, size_t num_keys, const char **texts);
 extern bool		sfHasString(sf_t *sf, const char *key);
 extern bool		sfLoadFile(sf_t *sf, const char *filename);
+extern bool		sfLoadMO(sf_t *sf, const char *filename);
 extern bool		sfLoadString(sf_t *sf, const char *data);
 extern sf_t		*sfNew(void);
 extern void		sfPrintf(FILE *fp, const char *message, ...);
@@ -54,7 +68,10 @@ extern void		sfPuts(FILE *fp, const char *message);
 extern void		sfRegisterDirectory(const char *directory);
 extern void		sfRegisterString(const char *locale, const char *data);
 extern bool		sfRemoveString(sf_t *sf, const char *key);
+extern bool		sfSaveMO(sf_t *sf, const char *filename);
+extern bool		sfSaveShared(sf_t *sf, const char *filename);
 extern void		sfSetLocale(void);
+extern sf_t		*sfSetThreadLocale(sf_t *sf);
 
 
 #  ifdef __cplusplus
@@ -1,19 +1,20 @@
 //
 // Strings file utility for StringsUtil.
 //
-// Copyright © 2022-2025 by Michael R Sweet.
+// Copyright © 2022-2026 by Michael R Sweet.
 //
 // Licensed under Apache License v2.0.  See the file "LICENSE" for more
 // information.
 //
 // Usage:
 //
-//   stringsutil scan -f FILENAME.strings SOURCE-FILE(S)
+//   stringsutil scan -f FILENAME.strings [-C] [-j JOBS] [-i PATTERN] [-x PATTERN] [-n NAME[:ARG]] {SOURCE-FILE,DIRECTORY,@LISTFILE,-} ...
+//   stringsutil sync -f FILENAME.strings [-c] [-C] [-j JOBS] [-i PATTERN] [-x PATTERN] [-n NAME[:ARG]] FILENAME-LL.strings ... {SOURCE-FILE,DIRECTORY,@LISTFILE,-} ...
 //   stringsutil merge [-c] -f FILENAME-LL.strings FILENAME.strings
-//   stringsutil export -f FILENAME.strings FILENAME.{c,cc,cpp,cxx,h,po}
-//   stringsutil import [-a] -f FILENAME.strings FILENAME.{po,strings}
-//   stringsutil report -f FILENAME.strings [-v] FILENAME-LL.strings
-//   stringsutil translate -f FILENAME.strings -l LOCALE [-A API-KEY] [-T URL]
+//   stringsutil export -f FILENAME.strings FILENAME.{c,cc,cpp,cxx,h,mo,po}
+//   stringsutil import [-a] -f FILENAME.strings FILENAME.{mo,po,strings}
+//   stringsutil report -f FILENAME.strings [-F FORMAT] [-j JOBS] [-v] FILENAME-LL.strings ...
+//   stringsutil translate -f FILENAME.strings -l LOCALE [-A API-KEY] [-T URL] [-b COUNT] [-B BYTES] [-j JOBS] [-M FILENAME] FILENAME-BASE.strings
 //
 
 #include "sf-private.h"
@@ -22,6 +23,8 @@
 #include <cups/cups.h>
 #ifndef _WIN32
 #  include <unistd.h>
+#  include <dirent.h>
+#  include <fnmatch.h>
 #  include <sys/ioctl.h>
 #endif // !_WIN32
 
@@ -86,27 +89,294 @@ typedef ipp_copycb_t ipp_copy_cb_t;
 #endif // CUPS_VERSION_MAJOR < 3
 
 
+//
+// Local types...
+//
+
+typedef struct import_buffer_s		// Growable string buffer
+{
+  char		*data;			// Nul-terminated string
+  size_t	len,			// Length of string
+		alloc;			// Allocated size
+} import_buffer_t;
+
+typedef struct import_entry_s		// PO file entry
+{
+  import_buffer_t comment,		// Comment
+		msgid,			// Message ID
+		msgid_plural,		// Plural message ID
+		msgstr[2];		// Singular and plural message strings
+  bool		context,		// Has a message context?
+		fuzzy,			// Fuzzy translation?
+		have_msgstr;		// Seen a message string?
+} import_entry_t;
+
+typedef struct json_reader_s		// Streaming JSON reader
+{
+  http_t	*http;			// Connection to read from
+  char		buffer[8192],		// Read buffer
+		*bufptr,		// Pointer into buffer
+		*bufend;		// End of buffer
+} json_reader_t;
+
+typedef struct report_issue_s		// Problem found in a strings file
+{
+  bool		format;			// Format mismatch (otherwise not translated)?
+  const char	*key,			// Key string
+		*text;			// Base text string
+} report_issue_t;
+
+typedef struct report_file_s		// Strings file to report on
+{
+  const char	*filename;		// Filename
+  bool		loaded;			// Was the file loaded?
+  char		error[256];		// Error message, if any
+  int		translated,		// Translated strings
+		untranslated,		// Strings that are not translated
+		missing,		// Missing strings
+		old,			// Old strings
+		errors;			// Format errors
+  size_t	num_issues,		// Number of issues
+		alloc_issues;		// Allocated issues
+  report_issue_t *issues;		// Issues, in key order
+} report_file_t;
+
+typedef struct report_job_s		// Parallel report job
+{
+#ifndef _WIN32
+  pthread_mutex_t mutex;		// Mutex for files
+#endif // !_WIN32
+  sf_t		*sf;			// Base strings
+  bool		verbose;		// Report strings that are not translated?
+  size_t	num_files,		// Number of files
+		next_file;		// Next file to report on
+  report_file_t	*files;			// Files
+} report_job_t;
+
+typedef struct scan_string_s		// Candidate string from a source file
+{
+  char		*text,			// Text string
+		*comment;		// Comment string or `NULL`
+  size_t	seq;			// Sequence number for sorting
+} scan_string_t;
+
+typedef struct scan_name_s		// Localization function name
+{
+  char		*name;			// Name
+  size_t	len;			// Length of name
+  int		arg;			// String argument number, starting at 1
+  int		next;			// Next name with the same string or -1
+} scan_name_t;
+
+typedef struct scan_file_s		// Source file to scan
+{
+  char		*filename;		// Filename
+  int		error;			// `errno` value or 0 on success
+  bool		scanned;		// Was the file scanned (not cached)?
+  long long	size,			// Size of file
+		mtime;			// Modification time of file
+  uint64_t	hash;			// Hash of file contents
+  const struct scan_file_s *cached;	// Cached scan results or `NULL`
+  size_t	num_strings,		// Number of candidate strings
+		alloc_strings;		// Allocated candidate strings
+  scan_string_t	*strings;		// Candidate strings
+} scan_file_t;
+
+typedef struct scan_cache_s		// Scan cache
+{
+  long long	mtime;			// Time of the cached scan
+  char		*data;			// Cache file data
+  size_t	num_files;		// Number of files
+  scan_file_t	*files;			// Files, sorted by name
+  scan_string_t	*strings;		// Strings for all files
+} scan_cache_t;
+
+typedef struct scan_job_s		// Parallel scan job
+{
+#ifndef _WIN32
+  pthread_mutex_t mutex;		// Mutex for files
+  pthread_cond_t cond;			// Condition for new files
+#endif // !_WIN32
+  const char	*funcnames;		// Localization function names for cache
+  size_t	num_names;		// Number of function names
+  scan_name_t	*names;			// Function names
+  size_t	num_states;		// Number of automaton states
+  int		*states,		// Automaton transitions (256 per state, premultiplied)
+		*matches,		// Name matched in each state or -1
+		*outputs,		// First matching state along the suffix links or -1
+		*dicts;			// Next matching state along the suffix links or -1
+  int		first;			// First character of all names or -1
+  const char * const *includes,		// Include patterns for directories
+		* const *excludes;	// Exclude patterns for directories
+  bool		use_cache;		// Use the scan cache?
+  const scan_cache_t *cache;		// Scan cache
+  long long	cache_mtime;		// Time of the cached scan
+  bool		done;			// Have all files been added?
+  size_t	num_files,		// Number of files
+		alloc_files,		// Allocated files
+		next_file;		// Next file to scan
+  scan_file_t	**files;		// Files
+} scan_job_t;
+
+typedef struct sync_file_s		// Locale strings file to synchronize
+{
+  const char	*filename;		// Strings filename
+  char		header[1024],		// C header filename
+		error[256];		// Error message, if any
+  bool		loaded;			// Was the file loaded?
+  int		status,			// Exit status
+		added,			// Number of added strings
+		removed;		// Number of removed strings
+} sync_file_t;
+
+typedef struct sync_job_s		// Parallel sync job
+{
+#ifndef _WIN32
+  pthread_mutex_t mutex;		// Mutex for files
+#endif // !_WIN32
+  sf_t		*sf;			// Base strings
+  bool		clean;			// Remove old strings?
+  size_t	num_files,		// Number of files
+		next_file;		// Next file to synchronize
+  sync_file_t	*files;			// Files
+} sync_job_t;
+
+typedef struct translate_item_s		// String queued for translation
+{
+  _sf_pair_t	*pair;			// Pair being translated
+  char		*text,			// Text with protected format specifiers
+		*localized;		// Translated text with protected format specifiers or `NULL` if not translated
+  struct translate_item_s *next;	// Next pair with the same text
+} translate_item_t;
+
+typedef struct translate_batch_s	// Strings sent in one request
+{
+  translate_item_t *items;		// First string
+  size_t	num_items;		// Number of strings
+  char		*error;			// Error message from service, if any
+  bool		done,			// Has the request completed?
+		failed;			// Did the request fail?
+} translate_batch_t;
+
+typedef struct translate_job_s		// Parallel translation job
+{
+#ifndef _WIN32
+  pthread_mutex_t mutex;		// Mutex for batches
+  pthread_cond_t cond;			// Condition for completed batches
+#endif // !_WIN32
+  int		num_request;		// Number of common request values
+  cups_option_t	*request;		// Common request values
+  http_t	**https;		// Connections to service
+  int		next_http;		// Next connection to use
+  size_t	num_batches,		// Number of batches
+		next_batch;		// Next batch to send
+  translate_batch_t *batches;		// Batches
+  bool		failed;			// Lost connection to the service?
+} translate_job_t;
+
+typedef struct write_buffer_s		// Buffered output file
+{
+  const char	*filename;		// Output filename
+  char		target[1024],		// Target of symbolic link
+		tempfile[1024];		// Temporary filename
+  int		fd;			// File descriptor
+  bool		error;			// Did a write fail?
+  size_t	used;			// Bytes in buffer
+  char		buffer[65536];		// Output buffer
+} write_buffer_t;
+
+typedef struct translate_entry_s	// Translation memory entry
+{
+  uint64_t	hash;			// Hash of source text
+  char		*text,			// Source text
+		*localized;		// Localized text
+} translate_entry_t;
+
+typedef struct translate_memory_s	// Translation memory
+{
+  const char	*url,			// Translation service URL
+		*source,		// Source language
+		*target;		// Target language
+  size_t	num_entries,		// Number of entries
+		alloc_entries;		// Size of hash table
+  translate_entry_t *entries;		// Hash table
+  write_buffer_t wb;			// Memory file for new translations
+} translate_memory_t;
+
+
 //
 // Local functions...
 //
 
-static bool	compare_formats(const char *s1, const char *s2);
-static int	decode_json(const char *data, cups_option_t **vars);
-static const char *decode_string(const char *data, char term, char *buffer, size_t bufsize);
 static char	*encode_json(int num_vars, cups_option_t *vars);
 static char	*encode_string(const char *s, char *bufptr, char *bufend);
 static int	export_strings(sf_t *sf, const char *sfname, const char *filename);
 static int	get_term_width(void);
-static void	import_string(sf_t *sf, char *msgid, char *msgstr, char *comment, bool addnew, int *added, int *ignored, int *modified);
+static bool	import_append(import_buffer_t *buf, const char *s, size_t len);
+static int	import_compare_pairs(_sf_pair_t **a, _sf_pair_t **b);
+static bool	import_entry(sf_t *sf, sf_t *nsf, import_entry_t *entry, bool addnew, int *ignored, int *modified);
+static bool	import_mo(sf_t *sf, const char *filename, bool addnew, int *added, int *ignored, int *modified);
+static bool	import_po(sf_t *sf, const char *filename, bool addnew, int *added, int *ignored, int *modified);
+static const char *import_quoted(import_buffer_t *buf, const char *ptr, const char *end);
+static bool	import_string(sf_t *sf, sf_t *nsf, const char *key, const char *text, const char *comment, bool addnew, int *ignored, int *modified);
 static int	import_strings(sf_t *sf, const char *sfname, const char *filename, bool addnew);
-static bool	matching_formats(const char *key, const char *text);
+static int	json_getc(json_reader_t *jr);
+static int	json_peek(json_reader_t *jr);
+static int	json_read_hex(json_reader_t *jr);
+static bool	json_read_string(json_reader_t *jr, char **buffer, size_t *bufsize);
+static int	json_skip_space(json_reader_t *jr);
+static bool	json_skip_value(json_reader_t *jr);
+static bool	matching_formats(_sf_pair_t *pair, const char *text);
 static int	merge_strings(sf_t *sf, const char *sfname, const char *filename, bool clean);
-static int	report_strings(sf_t *sf, const char *filename, bool verbose);
-static int	scan_files(sf_t *sf, const char *sfname, const char *funcname, int num_files, const char *files[]);
-static int	translate_strings(sf_t *sf, const char *sfname, const char *url, const char *apikey, const char *language, const char *filename);
+static bool	report_add_issue(report_file_t *file, bool format, const char *key, const char *text);
+static void	report_file(report_job_t *job, report_file_t *file);
+static int	report_strings(sf_t *sf, int num_files, const char *files[], int num_jobs, const char *format, bool verbose);
+static void	*report_thread(report_job_t *job);
+static bool	scan_add_file(scan_job_t *job, const char *filename, int error);
+static bool	scan_add_path(scan_job_t *job, const char *path, bool walk);
+static bool	scan_add_string(scan_file_t *file, const char *text, const char *comment);
+static bool	scan_build_names(scan_job_t *job, const char * const *funcnames);
+static bool	scan_call(scan_file_t *file, const char *ptr, const char *end, int arg);
+static int	scan_compare_files(scan_file_t *a, scan_file_t *b);
+static int	scan_compare_names(char **a, char **b);
+static int	scan_compare_paths(scan_file_t **a, scan_file_t **b);
+static int	scan_compare_strings(scan_string_t **a, scan_string_t **b);
+static void	scan_copy_strings(scan_file_t *file, const scan_file_t *cached);
+static void	scan_file(scan_job_t *job, scan_file_t *file);
+static int	scan_files(sf_t *sf, const char *sfname, const char * const *funcnames, int num_jobs, bool use_cache, bool rewrite, const char * const *includes, const char * const *excludes, int num_files, const char *files[]);
+static bool	scan_load_cache(scan_cache_t *cache, const char *cachename, const char *funcnames);
+static bool	scan_match(const char * const *patterns, const char *name, const char *path);
+static bool	scan_read_list(scan_job_t *job, const char *listfile);
+static char	*scan_read_string(char **ptr, char *end, size_t len);
+static bool	scan_save_cache(scan_job_t *job, const char *cachename, long long mtime);
+static const char *scan_skip(const char *ptr, const char *end, const char **cstart, const char **cend);
+static const char *scan_skip_arg(const char *ptr, const char *end);
+static void	*scan_thread(scan_job_t *job);
+static bool	scan_walk(scan_job_t *job, const char *dirname);
+static void	sync_file(sync_job_t *job, sync_file_t *file);
+static int	sync_strings(sf_t *sf, const char *sfname, const char * const *funcnames, int num_jobs, bool use_cache, const char * const *includes, const char * const *excludes, bool clean, int num_files, const char *files[]);
+static void	*sync_thread(sync_job_t *job);
+static char	*translate_decode(const char *s, const char *value);
+static char	*translate_encode(const char *s);
+static bool	translate_memory_add(translate_memory_t *tm, const char *text, const char *localized);
+static void	translate_memory_close(translate_memory_t *tm);
+static const char *translate_memory_find(translate_memory_t *tm, const char *text);
+static uint64_t	translate_memory_hash(const char *text);
+static translate_memory_t *translate_memory_open(const char *filename, const char *url, const char *source, const char *target);
+static void	translate_read(http_t *http, translate_batch_t *batch);
+static void	translate_send(translate_job_t *job, http_t *http, translate_batch_t *batch);
+static int	translate_strings(sf_t *sf, const char *sfname, const char *url, const char *apikey, const char *language, const char *filename, const char *memfile, int num_jobs, size_t batch_count, size_t batch_bytes);
+static void	*translate_thread(translate_job_t *job);
 static int	usage(FILE *fp, int status);
-static void	write_string(FILE *fp, const char *s, bool code);
+static bool	write_close(write_buffer_t *wb);
+static void	write_data(write_buffer_t *wb, const char *data, size_t len);
+static void	write_flush(write_buffer_t *wb);
+static bool	write_open(write_buffer_t *wb, const char *filename);
+static void	write_puts(write_buffer_t *wb, const char *s);
+static bool	write_replace(const char *tempfile, const char *filename);
+static void	write_string(write_buffer_t *wb, const char *s, bool code);
 static bool	write_strings(sf_t *sf, const char *sfname);
+static const char *write_target(const char *filename, char *buffer, size_t bufsize);
 
 
 //
@@ -118,18 +388,30 @@ main(int  argc,				// I - Number of command-line arguments
      char *argv[])			// I - Command-line arguments
 {
   int		i,			// Looping var
-		num_files = 0;		// Number of files
-  const char	*files[1000],		// Files
+		num_files = 0,		// Number of files
+		num_excludes = 0,	// Number of exclude patterns
+		num_funcnames = 0,	// Number of function names
+		num_includes = 0,	// Number of include patterns
+		num_jobs = 0;		// Number of parallel jobs (0 = auto)
+  size_t	batch_bytes = 16384,	// Maximum bytes per translation request
+		batch_count = 50;	// Maximum strings per translation request
+  const char	**files,		// Files
+		**excludes,		// Exclude patterns
+		**funcnames,		// Function names
+		**includes,		// Include patterns
 		*apikey = getenv("LIBRETRANSLATE_APIKEY"),
 					// API key
 		*command = NULL,	// Command
-		*funcname = "SFSTR",	// Function name
+		*format = "text",	// Report format
 		*language = NULL,	// Language code
+		*memfile = getenv("STRINGSUTIL_MEMORY"),
+					// Translation memory file
 		*url = getenv("LIBRETRANSLATE_URL"),
 					// URL to LibreTranslate server
 		*opt;			// Pointer to option
   bool		addnew = false,		// Add new strings on import?
 		clean = false,		// Clean old strings?
+		use_cache = false,	// Use scan cache?
 		verbose = false;	// Be verbose?
   const char	*sfname = NULL;		// Strings filename
   sf_t		*sf = NULL;		// Strings file
@@ -142,6 +424,17 @@ main(int  argc,				// I - Number of command-line arguments
   sfRegisterString("fr", fr_strings);
 
   // Parse command-line...
+  files    = calloc((size_t)argc + 1, sizeof(char *));
+  excludes  = calloc((size_t)argc + 1, sizeof(char *));
+  funcnames = calloc((size_t)argc + 2, sizeof(char *));
+  includes  = calloc((size_t)argc + 1, sizeof(char *));
+
+  if (!files || !excludes || !funcnames || !includes)
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to allocate memory: %s"), strerror(errno));
+    return (1);
+  }
+
   for (i = 1; i < argc; i ++)
   {
     if (!strcmp(argv[i], "--help"))
@@ -158,7 +451,7 @@ main(int  argc,				// I - Number of command-line arguments
       sfPrintf(stderr, SFSTR("stringsutil: Unknown option '%s'."), argv[i]);
       return (usage(stderr, 1));
     }
-    else if (argv[i][0] == '-')
+    else if (argv[i][0] == '-' && argv[i][1])
     {
       for (opt = argv[i] + 1; *opt; opt ++)
       {
@@ -175,6 +468,43 @@ main(int  argc,				// I - Number of command-line arguments
               apikey = argv[i];
               break;
 
+          case 'B' : // -B BYTES
+              i ++;
+              if (i >= argc || atoi(argv[i]) < 1)
+              {
+                sfPuts(stderr, SFSTR("stringsutil: Expected number of bytes after '-B'."));
+                return (usage(stderr, 1));
+              }
+
+              batch_bytes = (size_t)atoi(argv[i]);
+              break;
+
+          case 'C' : // -C
+              use_cache = true;
+              break;
+
+          case 'F' : // -F FORMAT
+              i ++;
+              if (i >= argc || (strcmp(argv[i], "csv") && strcmp(argv[i], "json") && strcmp(argv[i], "text")))
+              {
+                sfPuts(stderr, SFSTR("stringsutil: Expected report format after '-F'."));
+                return (usage(stderr, 1));
+              }
+
+              format = argv[i];
+              break;
+
+          case 'M' : // -M FILENAME
+              i ++;
+              if (i >= argc)
+              {
+                sfPuts(stderr, SFSTR("stringsutil: Expected translation memory filename after '-M'."));
+                return (usage(stderr, 1));
+              }
+
+              memfile = argv[i];
+              break;
+
           case 'T' : // -T URL
               i ++;
               if (i >= argc)
@@ -190,6 +520,17 @@ main(int  argc,				// I - Number of command-line arguments
               addnew = true;
               break;
 
+          case 'b' : // -b COUNT
+              i ++;
+              if (i >= argc || atoi(argv[i]) < 1)
+              {
+                sfPuts(stderr, SFSTR("stringsutil: Expected number of strings after '-b'."));
+                return (usage(stderr, 1));
+              }
+
+              batch_count = (size_t)atoi(argv[i]);
+              break;
+
           case 'c' : // -c
               clean = true;
               break;
@@ -202,13 +543,26 @@ main(int  argc,				// I - Number of command-line arguments
                 return (usage(stderr, 1));
               }
 
-              sf     = sfNew();
               sfname = argv[i];
+              break;
+
+          case 'i' : // -i PATTERN
+              i ++;
+              if (i >= argc)
+              {
+                sfPuts(stderr, SFSTR("stringsutil: Expected filename pattern after '-i'."));
+                return (usage(stderr, 1));
+              }
+
+              includes[num_includes ++] = argv[i];
+              break;
 
-              if (!sfLoadFile(sf, argv[i]) && errno != ENOENT)
+          case 'j' : // -j JOBS
+              i ++;
+              if (i >= argc || (num_jobs = atoi(argv[i])) < 1)
               {
-                sfPrintf(stderr, SFSTR("stringsutil: Unable to load '%s': %s"), argv[i], sfGetError(sf));
-                return (1);
+                sfPuts(stderr, SFSTR("stringsutil: Expected number of jobs after '-j'."));
+                return (usage(stderr, 1));
               }
               break;
 
@@ -223,48 +577,68 @@ main(int  argc,				// I - Number of command-line arguments
               language = argv[i];
               break;
 
-          case 'n' : // -n FUNCTION-NAME
+          case 'n' : // -n FUNCTION-NAME[:ARG]
               i ++;
               if (i >= argc)
               {
                 sfPuts(stderr, SFSTR("stringsutil: Expected function name after '-n'."));
                 return (usage(stderr, 1));
               }
-              funcname = argv[i];
+              funcnames[num_funcnames ++] = argv[i];
               break;
 
 	  case 'v' : // -v
 	      verbose = true;
 	      break;
 
+          case 'x' : // -x PATTERN
+              i ++;
+              if (i >= argc)
+              {
+                sfPuts(stderr, SFSTR("stringsutil: Expected filename pattern after '-x'."));
+                return (usage(stderr, 1));
+              }
+
+              excludes[num_excludes ++] = argv[i];
+              break;
+
 	  default :
 	      sfPrintf(stderr, SFSTR("stringsutil: Unknown option '-%c'."), *opt);
 	      return (usage(stderr, 1));
         }
       }
     }
-    else if (!strcmp(argv[i], "export") || !strcmp(argv[i], "import") || !strcmp(argv[i], "merge") || !strcmp(argv[i], "report") || !strcmp(argv[i], "scan") || !strcmp(argv[i], "translate"))
+    else if (!strcmp(argv[i], "export") || !strcmp(argv[i], "import") || !strcmp(argv[i], "merge") || !strcmp(argv[i], "report") || !strcmp(argv[i], "scan") || !strcmp(argv[i], "sync") || !strcmp(argv[i], "translate"))
     {
       command = argv[i];
     }
-    else if (num_files < (int)(sizeof(files) / sizeof(files[0])))
-    {
-      files[num_files ++] = argv[i];
-    }
     else
     {
-      sfPuts(stderr, SFSTR("stringsutil: Too many files."));
-      return (1);
+      files[num_files ++] = argv[i];
     }
   }
 
-  // Do the command...
-  if (!sf)
+  // Load the strings file, except for "sync" which creates it from the source
+  // files...
+  if (!sfname)
   {
     sfPuts(stderr, SFSTR("stringsutil: Expected strings file."));
     return (usage(stderr, 1));
   }
 
+  if ((sf = sfNew()) == NULL)
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to allocate memory: %s"), strerror(errno));
+    return (1);
+  }
+
+  if ((!command || strcmp(command, "sync")) && !sfLoadFile(sf, sfname) && errno != ENOENT)
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to load '%s': %s"), sfname, sfGetError(sf));
+    return (1);
+  }
+
+  // Do the command...
   if (!command)
   {
     sfPuts(stderr, SFSTR("stringsutil: Expected command name."));
@@ -272,9 +646,12 @@ main(int  argc,				// I - Number of command-line arguments
   }
   else if (!strcmp(command, "scan"))
   {
-    if (funcname)
+    if (num_funcnames == 0)
+      funcnames[num_funcnames ++] = "SFSTR";
+
+    if (funcnames[0][0])
     {
-      return (scan_files(sf, sfname, funcname, num_files, files));
+      return (scan_files(sf, sfname, funcnames, num_jobs, use_cache, false, includes, excludes, num_files, files));
     }
     else
     {
@@ -287,7 +664,7 @@ main(int  argc,				// I - Number of command-line arguments
     sfPrintf(stderr, SFSTR("stringsutil: Expected %s filename."), command);
     return (usage(stderr, 1));
   }
-  else if (num_files > 1)
+  else if (num_files > 1 && strcmp(command, "report") && strcmp(command, "sync"))
   {
     sfPuts(stderr, SFSTR("stringsutil: Too many files."));
     return (1);
@@ -300,6 +677,21 @@ main(int  argc,				// I - Number of command-line arguments
   {
     return (merge_strings(sf, sfname, files[0], clean));
   }
+  else if (!strcmp(command, "sync"))
+  {
+    if (num_funcnames == 0)
+      funcnames[num_funcnames ++] = "SFSTR";
+
+    if (funcnames[0][0])
+    {
+      return (sync_strings(sf, sfname, funcnames, num_jobs, use_cache, includes, excludes, clean, num_files, files));
+    }
+    else
+    {
+      sfPuts(stderr, SFSTR("stringsutil: Expected '-n FUNCTION-NAME' option."));
+      return (usage(stderr, 1));
+    }
+  }
   else if (stat(sfname, &sfinfo))
   {
     sfPrintf(stderr, SFSTR("stringsutil: Unable to load '%s': %s"), sfname, sfGetError(sf));
@@ -311,11 +703,11 @@ main(int  argc,				// I - Number of command-line arguments
   }
   else if (!strcmp(command, "report"))
   {
-    return (report_strings(sf, files[0], verbose));
+    return (report_strings(sf, num_files, files, num_jobs, format, verbose));
   }
   else if (!strcmp(command, "translate"))
   {
-    return (translate_strings(sf, sfname, url, apikey, language, files[0]));
+    return (translate_strings(sf, sfname, url, apikey, language, files[0], memfile, num_jobs, batch_count, batch_bytes));
   }
 
   return (0);
@@ -323,441 +715,125 @@ main(int  argc,				// I - Number of command-line arguments
 
 
 //
-// 'compare_formats()' - Compare two format strings.
-//
-
-static bool				// O - `true` if equal, `false` otherwise
-compare_formats(const char *s1,		// I - First string (key)
-                const char *s2)		// I - Second string (localized text)
-{
-  // Compare the two formats - s1 and s2 point after the % and any positional parameters
-  while (*s1 && *s2)
-  {
-    if (*s1 != *s2)
-      return (false);
-
-    if (isalpha(*s1 & 255))
-      break;
-
-    s1 ++;
-    s2 ++;
-  }
-
-  return (true);
-}
-
-
+// 'encode_json()' - Encode variables as a JSON object.
 //
-// 'decode_json()' - Decode an application/json object.
+// The caller is responsible for calling @code free@ on the returned string.
 //
 
-static int				// O - Number of JSON member variables or 0 on error
-decode_json(const char    *data,	// I - JSON data
-            cups_option_t **vars)	// O - JSON member variables or @code NULL@ on error
+static char *				// O - Encoded data or @code NULL@ on error
+encode_json(
+    int           num_vars,		// I - Number of JSON member variables
+    cups_option_t *vars)		// I - JSON member variables
 {
-  int	num_vars = 0;			// Number of form variables
-  char	name[1024],			// Variable name
-	value[4096],			// Variable value
-	*ptr,				// Pointer into value
-	*end;				// End of value
-
-
-  // Scan the string for "name":"value" pairs, unescaping values as needed.
-  *vars = NULL;
-
-  if (!data || *data != '{')
-    return (0);
-
-  data ++;
-
-  while (*data)
-  {
-    // Skip leading whitespace/commas...
-    while (*data && (isspace(*data & 255) || *data == ','))
-      data ++;
+  char		*buffer,		// Output buffer
+		*bufptr,		// Current position in buffer
+		*bufend;		// End of buffer
+  size_t	bufsize = 3;		// Size of output buffer
+  const char	*valptr;		// Pointer into value
+  int		i,			// Looping var
+		is_number;		// Is the value a number?
 
-    // Get the member variable name, unless we have the end of the object...
-    if (*data == '}')
-      break;
-    else if (*data != '\"')
-      goto decode_error;
 
-    data = decode_string(data + 1, '\"', name, sizeof(name));
+  // Each character is encoded using at most two characters...
+  for (i = 0; i < num_vars; i ++)
+    bufsize += 2 * (strlen(vars[i].name) + strlen(vars[i].value)) + 6;
 
-    if (*data != '\"')
-      goto decode_error;
+  if ((buffer = malloc(bufsize)) == NULL)
+    return (NULL);
 
-    data ++;
+  bufptr  = buffer;
+  bufend  = buffer + bufsize - 2;
 
-    if (*data != ':')
-      goto decode_error;
+  *bufptr++ = '{';
+  *bufend   = '\0';
 
-    data ++;
+  while (num_vars > 0)
+  {
+    bufptr = encode_string(vars->name, bufptr, bufend);
 
-    if (*data == '\"')
+    if (bufptr >= bufend)
     {
-      // Quoted string value...
-      data = decode_string(data + 1, '\"', value, sizeof(value));
+      free(buffer);
+      return (NULL);
+    }
 
-      if (*data != '\"')
-	goto decode_error;
+    *bufptr++ = ':';
 
-      data ++;
+    if (vars->value[0] == '[')
+    {
+      // Array value, already encoded...
+      strncpy(bufptr, vars->value, bufend - bufptr);
+      bufptr += strlen(bufptr);
     }
-    else if (*data == '[')
+    else
     {
-      // Array value...
-      ptr    = value;
-      end    = value + sizeof(value) - 1;
-      *ptr++ = '[';
+      is_number = 0;
 
-      for (data ++; *data && *data != ']';)
+      if (vars->value[0] == '-' || isdigit(vars->value[0] & 255))
       {
-        if (*data == ',')
-        {
-          if (ptr < end)
-            *ptr++ = *data++;
-	  else
-	    goto decode_error;
-        }
-        else if (*data == '\"')
-        {
-          // Quoted string value...
-          do
-          {
-	    if (*data == '\\')
-	    {
-	      if (ptr < end)
-		*ptr++ = *data++;
-	      else
-		goto decode_error;
-
-              if (!strchr("\\\"/bfnrtu", *data))
-                goto decode_error;
-
-	      if (*data == 'u')
-	      {
-		if (ptr < (end - 5))
-		  *ptr++ = *data++;
-		else
-		  goto decode_error;
-
-	        if (isxdigit(data[0] & 255) && isxdigit(data[1] & 255) && isxdigit(data[2] & 255) && isxdigit(data[3] & 255))
-	        {
-		  *ptr++ = *data++;
-		  *ptr++ = *data++;
-		  *ptr++ = *data++;
-		  /* 4th character is copied below */
-	        }
-	        else
-	          goto decode_error;
-	      }
-	    }
-
-	    if (ptr < end)
-	      *ptr++ = *data++;
-	    else
-	      goto decode_error;
-	  }
-	  while (*data && *data != '\"');
+	valptr = vars->value + 1;
+	while (*valptr && (isdigit(*valptr & 255) || *valptr == '.'))
+	  valptr ++;
 
-	  if (*data == '\"')
-	  {
-	    if (ptr < end)
-	      *ptr++ = *data++;
-	    else
-	      goto decode_error;
-	  }
-        }
-        else if (*data == '{' || *data == '[')
-        {
-          // Unsupported nested array or object value...
-	  goto decode_error;
-	}
-	else
+	if (*valptr == 'e' || *valptr == 'E' || !*valptr)
+	  is_number = 1;
+      }
+
+      if (is_number)
+      {
+        // Copy number literal...
+	for (valptr = vars->value; *valptr; valptr ++)
 	{
-	  // Number, boolean, etc.
-          while (*data && *data != ',' && !isspace(*data & 255))
-          {
-            if (ptr < end)
-              *ptr++ = *data++;
-	    else
-	      goto decode_error;
-	  }
+	  if (bufptr < bufend)
+	    *bufptr++ = *valptr;
 	}
       }
+      else
+      {
+        // Copy string value...
+	bufptr = encode_string(vars->value, bufptr, bufend);
+      }
+    }
 
-      if (*data != ']' || ptr >= end)
-        goto decode_error;
-
-      *ptr++ = *data++;
-      *ptr   = '\0';
+    num_vars --;
+    vars ++;
 
-      data ++;
-    }
-    else if (*data == '{')
-    {
-      // Unsupported object value...
-      goto decode_error;
-    }
-    else
+    if (num_vars > 0)
     {
-      // Number, boolean, etc.
-      for (ptr = value; *data && *data != ',' && !isspace(*data & 255); data ++)
-        if (ptr < (value + sizeof(value) - 1))
-          *ptr++ = *data;
+      if (bufptr >= bufend)
+      {
+        free(buffer);
+        return (NULL);
+      }
 
-      *ptr = '\0';
+      *bufptr++ = ',';
     }
-
-    // Add the variable...
-    num_vars = cupsAddOption(name, value, num_vars, vars);
   }
 
-  return (num_vars);
-
-  // If we get here there was an error in the form data...
-  decode_error:
-
-  cupsFreeOptions(num_vars, *vars);
-
-  *vars = NULL;
+  *bufptr++ = '}';
+  *bufptr   = '\0';
 
-  return (0);
+  return (buffer);
 }
 
 
 //
-// 'decode_string()' - Decode a URL-encoded string.
+// 'encode_string()' - URL-encode a string.
+//
+// The new buffer pointer can go past bufend, but we don't write past there...
 //
 
-static const char *                     // O - New pointer into string
-decode_string(const char *data,         // I - Pointer into data string
-              char       term,          // I - Terminating character
-              char       *buffer,       // I - String buffer
-              size_t     bufsize)       // I - Size of string buffer
+static char *                           // O - New buffer pointer
+encode_string(const char *s,            // I - String to encode
+              char       *bufptr,       // I - Pointer into buffer
+              char       *bufend)       // I - End of buffer
 {
-  int	ch;				// Current character
-  char	*ptr,				// Pointer info buffer
-	*end;				// Pointer to end of buffer
-
+  if (bufptr < bufend)
+    *bufptr++ = '\"';
 
-  for (ptr = buffer, end = buffer + bufsize - 1; *data && *data != term; data ++)
+  while (*s && bufptr < bufend)
   {
-    if ((ch = *data) == '\\')
-    {
-      // "\something" is an escaped character...
-      data ++;
-
-      switch (*data)
-      {
-        case '\\' :
-            ch = '\\';
-            break;
-        case '\"' :
-            ch = '\"';
-            break;
-        case '/' :
-            ch = '/';
-            break;
-        case 'b' :
-            ch = 0x08;
-            break;
-        case 'f' :
-            ch = 0x0c;
-            break;
-        case 'n' :
-            ch = 0x0a;
-            break;
-        case 'r' :
-            ch = 0x0d;
-            break;
-        case 't' :
-            ch = 0x09;
-            break;
-        case 'u' :
-            data ++;
-            if (isxdigit(data[0] & 255) && isxdigit(data[1] & 255) && isxdigit(data[2] & 255) && isxdigit(data[3] & 255))
-            {
-              if (isalpha(data[0]))
-                ch = (tolower(data[0]) - 'a' + 10) << 12;
-	      else
-	        ch = (data[0] - '0') << 12;
-
-              if (isalpha(data[1]))
-                ch |= (tolower(data[1]) - 'a' + 10) << 8;
-	      else
-	        ch |= (data[1] - '0') << 8;
-
-              if (isalpha(data[2]))
-                ch |= (tolower(data[2]) - 'a' + 10) << 4;
-	      else
-	        ch |= (data[2] - '0') << 4;
-
-              if (isalpha(data[3]))
-                ch |= tolower(data[3]) - 'a' + 10;
-	      else
-	        ch |= data[3] - '0';
-
-              data += 3;
-              break;
-            }
-
-            // Fall through to default on error
-	default :
-	    *buffer = '\0';
-	    return (NULL);
-      }
-
-      if (ch < 0x80)
-      {
-        // ASCII
-        if (ptr < end)
-          *ptr++ = (char)ch;
-      }
-      else if (ch < 0x400)
-      {
-        // 2-byte UTF-8
-        if (ptr < (end - 1))
-        {
-          *ptr++ = (char)(0xc0 | (ch >> 6));
-          *ptr++ = (char)(0x80 | (ch & 0x3f));
-        }
-      }
-      else if (ch < 0x10000)
-      {
-        // 3-byte UTF-8
-        if (ptr < (end - 2))
-        {
-          *ptr++ = (char)(0xe0 | (ch >> 12));
-          *ptr++ = (char)(0x80 | ((ch >> 6) & 0x3f));
-          *ptr++ = (char)(0x80 | (ch & 0x3f));
-        }
-      }
-      else
-      {
-        // 4-byte UTF-8
-        if (ptr < (end - 3))
-        {
-          *ptr++ = (char)(0xf0 | (ch >> 18));
-          *ptr++ = (char)(0x80 | ((ch >> 12) & 0x3f));
-          *ptr++ = (char)(0x80 | ((ch >> 6) & 0x3f));
-          *ptr++ = (char)(0x80 | (ch & 0x3f));
-        }
-      }
-    }
-    else if (ch && ptr < end)
-      *ptr++ = (char)ch;
-  }
-
-  *ptr = '\0';
-
-  return (data);
-}
-
-
-//
-// 'encode_json()' - Encode variables as a JSON object.
-//
-// The caller is responsible for calling @code free@ on the returned string.
-//
-
-static char *				// O - Encoded data or @code NULL@ on error
-encode_json(
-    int           num_vars,		// I - Number of JSON member variables
-    cups_option_t *vars)		// I - JSON member variables
-{
-  char		buffer[65536],		// Temporary buffer
-		*bufptr = buffer,	// Current position in buffer
-		*bufend = buffer + sizeof(buffer) - 2;
-					// End of buffer
-  const char	*valptr;		// Pointer into value
-  int		is_number;		// Is the value a number?
-
-  *bufptr++ = '{';
-  *bufend   = '\0';
-
-  while (num_vars > 0)
-  {
-    bufptr = encode_string(vars->name, bufptr, bufend);
-
-    if (bufptr >= bufend)
-      return (NULL);
-
-    *bufptr++ = ':';
-
-    if (vars->value[0] == '[')
-    {
-      // Array value, already encoded...
-      strncpy(bufptr, vars->value, bufend - bufptr);
-      bufptr += strlen(bufptr);
-    }
-    else
-    {
-      is_number = 0;
-
-      if (vars->value[0] == '-' || isdigit(vars->value[0] & 255))
-      {
-	valptr = vars->value + 1;
-	while (*valptr && (isdigit(*valptr & 255) || *valptr == '.'))
-	  valptr ++;
-
-	if (*valptr == 'e' || *valptr == 'E' || !*valptr)
-	  is_number = 1;
-      }
-
-      if (is_number)
-      {
-        // Copy number literal...
-	for (valptr = vars->value; *valptr; valptr ++)
-	{
-	  if (bufptr < bufend)
-	    *bufptr++ = *valptr;
-	}
-      }
-      else
-      {
-        // Copy string value...
-	bufptr = encode_string(vars->value, bufptr, bufend);
-      }
-    }
-
-    num_vars --;
-    vars ++;
-
-    if (num_vars > 0)
-    {
-      if (bufptr >= bufend)
-        return (NULL);
-
-      *bufptr++ = ',';
-    }
-  }
-
-  *bufptr++ = '}';
-  *bufptr   = '\0';
-
-  return (strdup(buffer));
-}
-
-
-//
-// 'encode_string()' - URL-encode a string.
-//
-// The new buffer pointer can go past bufend, but we don't write past there...
-//
-
-static char *                           // O - New buffer pointer
-encode_string(const char *s,            // I - String to encode
-              char       *bufptr,       // I - Pointer into buffer
-              char       *bufend)       // I - End of buffer
-{
-  if (bufptr < bufend)
-    *bufptr++ = '\"';
-
-  while (*s && bufptr < bufend)
-  {
-    if (*s == '\b')
+    if (*s == '\b')
     {
       *bufptr++ = '\\';
       if (bufptr < bufend)
@@ -799,7 +875,7 @@ encode_string(const char *s,            // I - String to encode
       if (bufptr < bufend)
         *bufptr++ = '\"';
     }
-    else if (*s >= ' ')
+    else if ((*s & 255) >= ' ')
       *bufptr++ = *s;
 
     s ++;
@@ -815,7 +891,7 @@ encode_string(const char *s,            // I - String to encode
 
 
 //
-// 'export_strings()' - Export strings to a PO or C header file.
+// 'export_strings()' - Export strings to a MO, PO, or C header file.
 //
 
 static int				// O - Exit status
@@ -825,23 +901,44 @@ export_strings(sf_t       *sf,		// I - Strings
 {
   const char	*ext;			// Filename extension
   bool		code;			// Writing C code?
-  FILE		*fp;			// File
+  write_buffer_t wb;			// Output file
   _sf_pair_t	*pair;			// Current pair
   size_t	count;			// Number of pairs remaining
 
 
-  if ((ext = strrchr(filename, '.')) == NULL || (strcmp(ext, ".po") && strcmp(ext, ".h") && strcmp(ext, ".c") && strcmp(ext, ".cc") && strcmp(ext, ".cpp") && strcmp(ext, ".cxx")))
+  if ((ext = strrchr(filename, '.')) == NULL || (strcmp(ext, ".mo") && strcmp(ext, ".po") && strcmp(ext, ".h") && strcmp(ext, ".c") && strcmp(ext, ".cc") && strcmp(ext, ".cpp") && strcmp(ext, ".cxx")))
   {
     sfPrintf(stderr, SFSTR("stringsutil: Unknown export format for '%s'."), filename);
     return (1);
   }
 
+  if (!strcmp(ext, ".mo"))
+  {
+    // Write a GNU gettext .mo file...
+    wb.filename = write_target(filename, wb.target, sizeof(wb.target));
+
+    snprintf(wb.tempfile, sizeof(wb.tempfile), "%s.%d", wb.filename, (int)getpid());
+
+    if (!sfSaveMO(sf, wb.tempfile))
+    {
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to export '%s': %s"), filename, sfGetError(sf));
+      return (1);
+    }
+    else if (!write_replace(wb.tempfile, wb.filename))
+    {
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to export '%s': %s"), sfname, strerror(errno));
+      return (1);
+    }
+
+    return (0);
+  }
+
   code = !strcmp(ext, ".h") || !strcmp(ext, ".c") || !strcmp(ext, ".cc") || !strcmp(ext, ".cpp") || !strcmp(ext, ".cxx");
 
-  if ((fp = fopen(filename, "w")) == NULL)
+  if (!write_open(&wb, filename))
   {
     sfPrintf(stderr, SFSTR("stringsutil: Unable to export '%s': %s"), sfname, strerror(errno));
-    return (false);
+    return (1);
   }
 
   if (code)
@@ -853,52 +950,46 @@ export_strings(sf_t       *sf,		// I - Strings
     else
       sfbase = sfname;
 
-    fputs("static const char *", fp);
+    write_puts(&wb, "static const char *");
     while (*sfbase)
     {
       if (isalnum(*sfbase & 255))
-        putc(*sfbase, fp);
+        write_data(&wb, sfbase, 1);
       else
-        putc('_', fp);
+        write_data(&wb, "_", 1);
 
       sfbase ++;
     }
-    fputs(" = ", fp);
+    write_puts(&wb, " = ");
   }
 
   for (count = sf->num_pairs, pair = sf->pairs; count > 0; count --, pair ++)
   {
-    if (code)
-    {
-      if (pair->comment)
-	fprintf(fp, "/* %s */\n", pair->comment);
-      fputs("\"", fp);
-    }
-    else
+    if (pair->comment)
     {
-      if (pair->comment)
-	fprintf(fp, "# %s\n", pair->comment);
-      fputs("msgid ", fp);
+      write_puts(&wb, code ? "/* " : "# ");
+      write_puts(&wb, pair->comment);
+      write_puts(&wb, code ? " */\n" : "\n");
     }
 
-    write_string(fp, pair->key, code);
-
-    if (code)
-      fputs(" = ", fp);
-    else
-      fputs("\nmsgstr ", fp);
-
-    write_string(fp, pair->text, code);
+    write_puts(&wb, code ? "\"" : "msgid ");
+    write_string(&wb, pair->key, code);
+    write_puts(&wb, code ? " = " : "\nmsgstr ");
+    write_string(&wb, pair->text, code);
 
     if (code && count > 1)
-      fputs(";\\n\"\n", fp);
+      write_puts(&wb, ";\\n\"\n");
     else if (code)
-      fputs(";\\n\";\n", fp);
+      write_puts(&wb, ";\\n\";\n");
     else
-      fputs("\n\n", fp);
+      write_puts(&wb, "\n\n");
   }
 
-  fclose(fp);
+  if (!write_close(&wb))
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to export '%s': %s"), sfname, strerror(errno));
+    return (1);
+  }
 
   return (0);
 }
@@ -930,697 +1021,3873 @@ get_term_width(void)
 
 
 //
-// 'import_string()' - Import a single string.
+// 'import_append()' - Append to a growable string buffer.
 //
 
-static void
-import_string(sf_t *sf,			// I  - Strings
-              char *msgid,		// I  - Key string
-              char *msgstr,		// I  - Localized text
-              char *comment,		// I  - Comment, if any
-              bool addnew,		// I  - Add new strings?
-              int  *added,		// IO - Number of added strings
-              int  *ignored,		// IO - Number of ignored strings
-              int  *modified)		// IO - Number of modified strings
+static bool				// O - `true` on success, `false` on error
+import_append(import_buffer_t *buf,	// I - Buffer
+              const char      *s,	// I - String to append
+              size_t          len)	// I - Length of string
 {
-  _sf_pair_t	*match;			// Matching existing entry
-  bool		clear = false;		// Clear incoming strings?
+  char		*data;			// New string data
+  size_t	alloc;			// New allocated size
 
 
-  if (*msgid && *msgstr)
+  if ((buf->len + len) >= buf->alloc)
   {
-    // See if this is an existing string...
-    if ((match = _sfFindPair(sf, msgid)) != NULL)
-    {
-      // Found a match...
-      if (strcmp(match->text, msgstr))
-      {
-	// Modify the localization...
-	free(match->text);
-	match->text = strdup(msgstr);
-	(*modified) ++;
-	clear = true;
-      }
-    }
-    else if (addnew)
-    {
-      // Add new string...
-      sfAddString(sf, msgid, msgstr, comment);
-      (*added) ++;
-      clear = true;
-    }
-    else
-    {
-      // Ignore string...
-      (*ignored) ++;
-      clear = true;
-    }
-  }
+    for (alloc = buf->alloc ? buf->alloc : 1024; alloc <= (buf->len + len); alloc *= 2);
 
-  if (clear)
-  {
-    // Clear the incoming string...
-    *msgid   = '\0';
-    *msgstr  = '\0';
-    *comment = '\0';
+    if ((data = realloc(buf->data, alloc)) == NULL)
+      return (false);
+
+    buf->data  = data;
+    buf->alloc = alloc;
   }
+
+  memcpy(buf->data + buf->len, s, len);
+  buf->len += len;
+  buf->data[buf->len] = '\0';
+
+  return (true);
 }
 
 
 //
-// 'import_strings()' - Import strings from a PO file.
+// 'import_compare_pairs()' - Compare two new pairs by key and order.
 //
 
-static int				// O - Exit status
-import_strings(sf_t       *sf,		// I - Strings
-               const char *sfname,	// I - Strings filename
-               const char *filename,	// I - Import filename
-               bool       addnew)	// I - Add new strings?
+static int				// O - Result of comparison
+import_compare_pairs(_sf_pair_t **a,	// I - First pair
+                     _sf_pair_t **b)	// I - Second pair
 {
-  const char	*ext;			// Filename extension...
-  int		linenum = 0,		// Current line number
-		added = 0,		// Number of added strings
-		ignored = 0,		// Number of ignored strings
-		modified = 0;		// Number of modified strings
+  int	result;				// Result of comparison
 
 
-  if ((ext = strrchr(filename, '.')) == NULL || (strcmp(ext, ".po") && strcmp(ext, ".strings")))
-  {
-    sfPrintf(stderr, SFSTR("stringsutil: Unknown import format for '%s'."), filename);
-    return (1);
-  }
+  if ((result = strcmp((*a)->key, (*b)->key)) != 0)
+    return (result);
+  else if (*a < *b)
+    return (-1);
+  else
+    return (*a > *b);
+}
 
-  if (!strcmp(ext, ".po"))
-  {
-    // Import a GNU gettext .po file...
-    FILE	*fp;			// PO file
-    char	line[1024],		// Line buffer
-		*lineptr,		// Pointer into line
-		comment[1024] = "",	// Comment string
-		msgid[1024] = "",	// msgid buffer
-		msgstr[1024] = "",	// msgstr buffer
-		*end = NULL,		// End of buffer
-		*ptr = NULL;		// Position in buffer
-
-    // Open the PO file...
-    if ((fp = fopen(filename, "r")) == NULL)
-    {
-      sfPrintf(stderr, SFSTR("stringsutil: Unable to import '%s': %s"), filename, strerror(errno));
-      return (1);
-    }
 
-    // Read lines until the end...
-    while (fgets(line, sizeof(line), fp))
-    {
-      linenum ++;
+//
+// 'import_entry()' - Import a PO file entry and clear it.
+//
+// The singular message string is imported for the message ID and the first
+// plural message string for the plural message ID.  Fuzzy entries are not
+// imported.
+//
 
-      lineptr = line;
+static bool				// O - `true` on success, `false` on error
+import_entry(sf_t           *sf,	// I  - Strings
+             sf_t           *nsf,	// I  - New strings
+             import_entry_t *entry,	// I  - PO file entry
+             bool           addnew,	// I  - Add new strings?
+             int            *ignored,	// IO - Number of ignored strings
+             int            *modified)	// IO - Number of modified strings
+{
+  bool	ret = true;			// Return value
 
-      if (*lineptr == '#')
-      {
-	// Comment...
-	import_string(sf, msgid, msgstr, comment, addnew, &added, &ignored, &modified);
 
-	// Skip whitespace
-	lineptr ++;
-	while (*lineptr && isspace(*lineptr & 255))
-	  lineptr ++;
+  if (entry->have_msgstr && entry->context)
+  {
+    // Strings files have no message contexts, don't replace the string without
+    // a context...
+    (*ignored) ++;
+  }
+  else if (entry->have_msgstr && !entry->fuzzy)
+  {
+    if (entry->msgid.len && entry->msgstr[0].len)
+      ret = import_string(sf, nsf, entry->msgid.data, entry->msgstr[0].data, entry->comment.data, addnew, ignored, modified);
 
-	// Append comment...
-	ptr = comment + strlen(comment);
-	end = comment + sizeof(comment) - 1;
+    if (ret && entry->msgid_plural.len && entry->msgstr[1].len)
+      ret = import_string(sf, nsf, entry->msgid_plural.data, entry->msgstr[1].data, entry->comment.data, addnew, ignored, modified);
+  }
 
-	if (ptr > comment && ptr < end)
-	  *ptr++ = ' ';			// Add initial space if this isn't the first comment line
+  if (entry->have_msgstr)
+  {
+    // Clear the entry for the next one...
+    entry->comment.len      = 0;
+    entry->msgid.len        = 0;
+    entry->msgid_plural.len = 0;
+    entry->msgstr[0].len    = 0;
+    entry->msgstr[1].len    = 0;
+    entry->context          = false;
+    entry->fuzzy            = false;
+    entry->have_msgstr      = false;
+
+    if (entry->comment.data)
+      entry->comment.data[0] = '\0';
+  }
 
-	while (*lineptr && *lineptr != '\n' && ptr < end)
-	  *ptr++ = *lineptr++;
+  return (ret);
+}
 
-	*ptr = '\0';
-	ptr  = end = NULL;
-	continue;
-      }
-      else if (!strncmp(line, "msgid ", 6))
-      {
-	// Start of message ID...
-	import_string(sf, msgid, msgstr, comment, addnew, &added, &ignored, &modified);
 
-	lineptr += 6;
-	while (*lineptr && isspace(*lineptr & 255))
-	  lineptr ++;
+//
+// 'import_mo()' - Import strings from a GNU gettext MO file.
+//
+// Existing strings are looked up using the hash table in the file and updated
+// in place, and new strings are merged in a single pass at the end.
+//
 
-	ptr = msgid;
-	end = msgid + sizeof(msgid) - 1;
-      }
-      else if (!strncmp(line, "msgstr ", 7))
-      {
-	// Start of message string...
-	lineptr += 7;
-	while (*lineptr && isspace(*lineptr & 255))
-	  lineptr ++;
+static bool				// O - `true` on success, `false` on error
+import_mo(sf_t       *sf,		// I  - Strings
+          const char *filename,		// I  - MO filename
+          bool       addnew,		// I  - Add new strings?
+          int        *added,		// IO - Number of added strings
+          int        *ignored,		// IO - Number of ignored strings
+          int        *modified)		// IO - Number of modified strings
+{
+  bool		ret = false;		// Return value
+  sf_t		*isf;			// Import strings
+  _sf_pair_t	*pair;			// Current pair
+  size_t	count,			// Number of pairs remaining
+		found = 0;		// Number of existing strings
+  const char	*text;			// Imported text
+  char		*newtext;		// New localized text
+  int		removed;		// Number of removed strings (unused)
 
-	ptr = msgstr;
-	end = msgstr + sizeof(msgstr) - 1;
-      }
-      else if (*lineptr == '\n')
-      {
-	// Blank line
-	import_string(sf, msgid, msgstr, comment, addnew, &added, &ignored, &modified);
-	ptr = end = NULL;
-	comment[0] = '\0';
-	continue;
-      }
 
-      if (*lineptr != '\"' || !ptr)
-      {
-	// Something unexpected...
-	sfPrintf(stderr, SFSTR("stringsutil: Syntax error on line %d of '%s'."), linenum, filename);
-	fclose(fp);
-	return (1);
-      }
+  if ((isf = sfNew()) == NULL)
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to import '%s': %s"), filename, strerror(errno));
+    return (false);
+  }
 
-      // Append string...
-      lineptr ++;
-      while (*lineptr && *lineptr != '\"')
-      {
-	if (*lineptr == '\\')
-	{
-	  // Add escaped character...
-	  int	ch;			// Escaped character
+  if (!sfLoadMO(isf, filename) || !_sfCopyMO(isf))
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to import '%s': %s"), filename, sfGetError(isf));
+    goto done;
+  }
 
-	  lineptr ++;
-	  if (*lineptr == '\\' || *lineptr == '\"' || *lineptr == '\'')
-	  {
-	    // Simple escape...
-	    ch = *lineptr;
-	  }
-	  else if (*lineptr == 'n')
-	  {
-	    // Newline
-	    ch = '\n';
-	  }
-	  else if (*lineptr == 'r')
-	  {
-	    // Carriage return
-	    ch = '\r';
-	  }
-	  else if (*lineptr == 't')
-	  {
-	    // Horizontal tab
-	    ch = '\t';
-	  }
-	  else if (*lineptr >= '0' && *lineptr <= '3' && lineptr[1] >= '0' && lineptr[1] <= '7' && lineptr[2] >= '0' && lineptr[2] <= '7')
-	  {
-	    // Octal escape
-	    ch = ((*lineptr - '0') << 6) | ((lineptr[1] - '0') << 3) | (lineptr[2] - '0');
-	  }
-	  else
-	  {
-	    sfPrintf(stderr, SFSTR("stringsutil: Syntax error on line %d of '%s'."), linenum, filename);
-	    fclose(fp);
-	    return (1);
-	  }
+  // Update existing strings...
+  for (count = sf->num_pairs, pair = sf->pairs; count > 0; count --, pair ++)
+  {
+    if ((text = _sfGetMO(isf, pair->key)) == NULL)
+      continue;
 
-	  if (ptr < end)
-	    *ptr++ = (char)ch;
-	}
-	else if (ptr < end)
-	{
-	  // Add literal character...
-	  *ptr++ = *lineptr;
-	}
+    found ++;
 
-	lineptr ++;
+    if (strcmp(pair->text, text))
+    {
+      if ((newtext = strdup(text)) == NULL)
+      {
+	sfPrintf(stderr, SFSTR("stringsutil: Unable to import '%s': %s"), filename, strerror(errno));
+	goto done;
       }
 
-      *ptr = '\0';
+      free(pair->text);
+      pair->text = newtext;
+      (*modified) ++;
     }
+  }
 
-    // All done, import the last string, if any...
-    import_string(sf, msgid, msgstr, comment, addnew, &added, &ignored, &modified);
+  if (addnew)
+  {
+    // Add new strings in a single pass...
+    _sf_rwlock_wrlock(sf->rwlock);
+    ret = _sfMergePairs(sf, isf, false, added, &removed);
+    _sf_rwlock_unlock(sf->rwlock);
+
+    if (!ret)
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to import '%s': %s"), filename, sfGetError(sf));
+  }
+  else
+  {
+    (*ignored) += (int)(isf->num_pairs - found);
+    ret = true;
+  }
+
+  done:
+
+  sfDelete(isf);
+
+  return (ret);
+}
+
+
+//
+// 'import_po()' - Import strings from a GNU gettext PO file.
+//
+// The file is mapped into memory and parsed one line at a time into growable
+// buffers, so there are no limits on the length of lines or strings.  Existing
+// strings are updated in place and new strings are merged in a single pass at
+// the end.  Strings files have no message contexts, so entries with a
+// "msgctxt" are skipped and the last definition of a message ID wins.
+//
+
+static bool				// O - `true` on success, `false` on error
+import_po(sf_t       *sf,		// I  - Strings
+          const char *filename,		// I  - PO filename
+          bool       addnew,		// I  - Add new strings?
+          int        *added,		// IO - Number of added strings
+          int        *ignored,		// IO - Number of ignored strings
+          int        *modified)		// IO - Number of modified strings
+{
+  bool		ret = false;		// Return value
+  int		fd;			// File descriptor
+  struct stat	fileinfo;		// File information
+  size_t	datasize;		// Size of file data
+  char		*data = NULL;		// File data
+  const char	*line,			// Start of current line
+		*lineend,		// End of current line
+		*dataend,		// End of file data
+		*ptr,			// Pointer into line
+		*end;			// End of comment
+  int		linenum = 0,		// Current line number
+		removed;		// Number of removed strings (unused)
+  sf_t		*nsf;			// New strings
+  import_entry_t entry;			// Current entry
+  import_buffer_t *target = NULL;	// Current string
+  bool		discard = false;	// Discard the current string?
+  _sf_pair_t	**sorted = NULL,	// New pairs sorted by key
+		*pairs = NULL;		// Unique new pairs
+  size_t	i,			// Looping var
+		count;			// Number of unique new pairs
+
+
+  // Map the PO file into memory...
+  if ((fd = open(filename, O_RDONLY)) < 0 || fstat(fd, &fileinfo))
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to import '%s': %s"), filename, strerror(errno));
+    if (fd >= 0)
+      close(fd);
+    return (false);
+  }
+
+  if ((datasize = (size_t)fileinfo.st_size) > 0)
+  {
+#ifdef _WIN32
+    if ((data = malloc(datasize)) != NULL && read(fd, data, (unsigned)datasize) != (int)datasize)
+    {
+      free(data);
+      data = NULL;
+    }
+
+#else
+    if ((data = mmap(NULL, datasize, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+      data = NULL;
+#endif // _WIN32
+
+    if (!data)
+    {
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to import '%s': %s"), filename, strerror(errno ? errno : EIO));
+      close(fd);
+      return (false);
+    }
+  }
+
+  close(fd);
+
+  memset(&entry, 0, sizeof(entry));
+  nsf = sfNew();
+
+  // Parse lines until the end...
+  for (line = data, dataend = data + datasize; line < dataend; line = lineend + 1)
+  {
+    linenum ++;
+
+    if ((lineend = memchr(line, '\n', (size_t)(dataend - line))) == NULL)
+      lineend = dataend;
+
+    for (ptr = line; ptr < lineend && isspace(*ptr & 255); ptr ++);
+
+    if (ptr >= lineend)
+    {
+      // Blank line...
+      if (!import_entry(sf, nsf, &entry, addnew, ignored, modified))
+        goto nomem;
+
+      entry.comment.len = 0;
+      if (entry.comment.data)
+        entry.comment.data[0] = '\0';
+
+      target  = NULL;
+      discard = false;
+      continue;
+    }
+    else if (*ptr == '#')
+    {
+      // Comment, flags, or obsolete entry...
+      if (!import_entry(sf, nsf, &entry, addnew, ignored, modified))
+        goto nomem;
+
+      target  = NULL;
+      discard = false;
+
+      if (ptr[1] == ',')
+      {
+        // Flags...
+        for (ptr += 2; ptr < lineend; ptr ++)
+        {
+          if ((lineend - ptr) >= 5 && !memcmp(ptr, "fuzzy", 5) && (ptr == line + 2 || !isalnum(ptr[-1] & 255)) && (ptr + 5 == lineend || !isalnum(ptr[5] & 255)))
+          {
+            entry.fuzzy = true;
+            break;
+          }
+        }
+      }
+      else if (ptr[1] != '~' && ptr[1] != '|')
+      {
+        // Comment, trim whitespace and append...
+	for (ptr ++; ptr < lineend && isspace(*ptr & 255); ptr ++);
+	for (end = lineend; end > ptr && isspace(end[-1] & 255); end --);
+
+        if (ptr < end && entry.comment.len && !import_append(&entry.comment, " ", 1))
+          goto nomem;
+
+        if (!import_append(&entry.comment, ptr, (size_t)(end - ptr)))
+          goto nomem;
+      }
+      continue;
+    }
+    else if (*ptr != '\"')
+    {
+      // Keyword...
+      discard = false;
+
+      if (!strncmp(ptr, "msgctxt ", 8))
+      {
+        // Start of a new entry with a context, which is skipped...
+        if (!import_entry(sf, nsf, &entry, addnew, ignored, modified))
+          goto nomem;
+
+        target        = NULL;
+        discard       = true;
+        entry.context = true;
+        ptr           += 8;
+      }
+      else if (!strncmp(ptr, "msgid ", 6))
+      {
+        // Start of message ID, which also starts a new entry if needed...
+        if (!import_entry(sf, nsf, &entry, addnew, ignored, modified))
+          goto nomem;
+
+        target = &entry.msgid;
+        ptr    += 6;
+      }
+      else if (!strncmp(ptr, "msgid_plural ", 13))
+      {
+        target = &entry.msgid_plural;
+        ptr    += 13;
+      }
+      else if (!strncmp(ptr, "msgstr ", 7))
+      {
+        target = entry.msgstr + 0;
+        ptr    += 7;
+
+        entry.have_msgstr = true;
+      }
+      else if (!strncmp(ptr, "msgstr[", 7) && isdigit(ptr[7] & 255))
+      {
+        for (ptr += 7, i = 0; isdigit(*ptr & 255); ptr ++)
+          i = 10 * i + (size_t)(*ptr - '0');
+
+        if (*ptr++ != ']')
+          goto syntax;
+
+        if (i < 2)
+        {
+          target = entry.msgstr + i;
+        }
+        else
+        {
+          target  = NULL;
+          discard = true;
+        }
+
+        entry.have_msgstr = true;
+      }
+      else
+      {
+        goto syntax;
+      }
+
+      while (ptr < lineend && isspace(*ptr & 255))
+        ptr ++;
+
+      if (ptr >= lineend || *ptr != '\"')
+        goto syntax;
+    }
+    else if (!target && !discard)
+    {
+      // Continuation without a keyword...
+      goto syntax;
+    }
+
+    // Append string...
+    if ((ptr = import_quoted(target, ptr, lineend)) == NULL)
+      goto syntax;
+
+    while (ptr < lineend && isspace(*ptr & 255))
+      ptr ++;
+
+    if (ptr < lineend)
+      goto syntax;
+  }
+
+  // Import the last entry, if any...
+  if (!import_entry(sf, nsf, &entry, addnew, ignored, modified))
+    goto nomem;
+
+  // Merge new strings, keeping the last definition of each key...
+  if (nsf->num_pairs > 0)
+  {
+    if ((sorted = malloc(nsf->num_pairs * sizeof(_sf_pair_t *))) == NULL || (pairs = malloc(nsf->num_pairs * sizeof(_sf_pair_t))) == NULL)
+      goto nomem;
+
+    for (i = 0; i < nsf->num_pairs; i ++)
+      sorted[i] = nsf->pairs + i;
+
+    qsort(sorted, nsf->num_pairs, sizeof(_sf_pair_t *), (int (*)(const void *, const void *))import_compare_pairs);
+
+    for (i = 0, count = 0; i < nsf->num_pairs; i ++)
+    {
+      if ((i + 1) < nsf->num_pairs && !strcmp(sorted[i]->key, sorted[i + 1]->key))
+      {
+        free(sorted[i]->key);
+        free(sorted[i]->text);
+        free(sorted[i]->comment);
+      }
+      else
+      {
+        pairs[count ++] = *sorted[i];
+      }
+    }
+
+    free(nsf->pairs);
+
+    nsf->pairs       = pairs;
+    nsf->num_pairs   = count;
+    nsf->alloc_pairs = count;
+    nsf->need_sort   = false;
+    pairs            = NULL;
+
+    _sf_rwlock_wrlock(sf->rwlock);
+    ret = _sfMergePairs(sf, nsf, false, added, &removed);
+    _sf_rwlock_unlock(sf->rwlock);
+
+    if (!ret)
+    {
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to import '%s': %s"), filename, sfGetError(sf));
+      goto done;
+    }
+  }
+
+  ret = true;
+  goto done;
+
+  // If we get here there was an error...
+  nomem:
+
+  sfPrintf(stderr, SFSTR("stringsutil: Unable to import '%s': %s"), filename, strerror(ENOMEM));
+  goto done;
+
+  syntax:
+
+  sfPrintf(stderr, SFSTR("stringsutil: Syntax error on line %d of '%s'."), linenum, filename);
+
+  // Free memory and return...
+  done:
+
+  free(sorted);
+  free(pairs);
+  free(entry.comment.data);
+  free(entry.msgid.data);
+  free(entry.msgid_plural.data);
+  free(entry.msgstr[0].data);
+  free(entry.msgstr[1].data);
+  sfDelete(nsf);
+
+#ifdef _WIN32
+  free(data);
+#else
+  if (data)
+    munmap(data, datasize);
+#endif // _WIN32
+
+  return (ret);
+}
+
+
+//
+// 'import_quoted()' - Append a quoted PO string to a buffer.
+//
+
+static const char *			// O - Pointer after string or `NULL` on error
+import_quoted(import_buffer_t *buf,	// I - Buffer or `NULL` to discard
+              const char      *ptr,	// I - Pointer to opening quote
+              const char      *end)	// I - End of line
+{
+  const char	*start;			// Start of literal characters
+  char		ch;			// Escaped character
+
+
+  for (ptr ++, start = ptr; ptr < end && *ptr != '\"'; ptr ++)
+  {
+    if (*ptr != '\\')
+      continue;
+
+    // Add literal characters and then the escaped character...
+    if (buf && ptr > start && !import_append(buf, start, (size_t)(ptr - start)))
+      return (NULL);
+
+    if (++ ptr >= end)
+      return (NULL);
+
+    if (*ptr == '\\' || *ptr == '\"' || *ptr == '\'')
+    {
+      // Simple escape...
+      ch = *ptr;
+    }
+    else if (*ptr == 'n')
+    {
+      // Newline
+      ch = '\n';
+    }
+    else if (*ptr == 'r')
+    {
+      // Carriage return
+      ch = '\r';
+    }
+    else if (*ptr == 't')
+    {
+      // Horizontal tab
+      ch = '\t';
+    }
+    else if ((end - ptr) >= 3 && *ptr >= '0' && *ptr <= '3' && ptr[1] >= '0' && ptr[1] <= '7' && ptr[2] >= '0' && ptr[2] <= '7')
+    {
+      // Octal escape
+      ch  = (char)(((*ptr - '0') << 6) | ((ptr[1] - '0') << 3) | (ptr[2] - '0'));
+      ptr += 2;
+    }
+    else
+    {
+      return (NULL);
+    }
+
+    if (buf && !import_append(buf, &ch, 1))
+      return (NULL);
+
+    start = ptr + 1;
+  }
+
+  if (ptr >= end)
+    return (NULL);			// No closing quote
+
+  if (buf && ptr > start && !import_append(buf, start, (size_t)(ptr - start)))
+    return (NULL);
+
+  return (ptr + 1);
+}
+
+
+//
+// 'import_string()' - Import a single string.
+//
+// Existing strings are updated in place, new strings are added to "nsf" to be
+// merged later.
+//
+
+static bool				// O  - `true` on success, `false` on error
+import_string(sf_t       *sf,		// I  - Strings
+              sf_t       *nsf,		// I  - New strings
+              const char *key,		// I  - Key string
+              const char *text,		// I  - Localized text
+              const char *comment,	// I  - Comment, if any
+              bool       addnew,	// I  - Add new strings?
+              int        *ignored,	// IO - Number of ignored strings
+              int        *modified)	// IO - Number of modified strings
+{
+  _sf_pair_t	*match;			// Matching existing entry
+  char		*newtext;		// New localized text
+
+
+  if ((match = _sfFindPair(sf, key)) != NULL)
+  {
+    // Found a match...
+    if (strcmp(match->text, text))
+    {
+      // Modify the localization...
+      if ((newtext = strdup(text)) == NULL)
+        return (false);
+
+      free(match->text);
+      match->text = newtext;
+      (*modified) ++;
+    }
+  }
+  else if (addnew)
+  {
+    // Add new string...
+    if (!_sfAddPair(nsf, key, text, comment))
+      return (false);
+  }
+  else
+  {
+    // Ignore string...
+    (*ignored) ++;
+  }
+
+  return (true);
+}
+
+
+//
+// 'import_strings()' - Import strings from a MO, PO, or strings file.
+//
+
+static int				// O - Exit status
+import_strings(sf_t       *sf,		// I - Strings
+               const char *sfname,	// I - Strings filename
+               const char *filename,	// I - Import filename
+               bool       addnew)	// I - Add new strings?
+{
+  const char	*ext;			// Filename extension...
+  int		added = 0,		// Number of added strings
+		ignored = 0,		// Number of ignored strings
+		modified = 0,		// Number of modified strings
+		removed;		// Number of removed strings (unused)
+
+
+  if ((ext = strrchr(filename, '.')) == NULL || (strcmp(ext, ".mo") && strcmp(ext, ".po") && strcmp(ext, ".strings")))
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unknown import format for '%s'."), filename);
+    return (1);
+  }
+
+  if (!strcmp(ext, ".po"))
+  {
+    // Import a GNU gettext .po file...
+    if (!import_po(sf, filename, addnew, &added, &ignored, &modified))
+      return (1);
+  }
+  else if (!strcmp(ext, ".mo"))
+  {
+    // Import a GNU gettext .mo file...
+    if (!import_mo(sf, filename, addnew, &added, &ignored, &modified))
+      return (1);
+  }
+  else
+  {
+    // Import a .strings file...
+    sf_t	*isf;			// Import strings
+    _sf_pair_t	*pair,			// Existing pair
+		*ipair;			// Imported pair
+    size_t	count;			// Number of pairs
+    bool	merged;			// Merged new strings?
+
+    isf = sfNew();
+    if (!sfLoadFile(isf, filename))
+    {
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to import '%s': %s"), filename, sfGetError(isf));
+      sfDelete(isf);
+      return (1);
+    }
+
+    for (count = isf->num_pairs, ipair = isf->pairs; count > 0; count --, ipair ++)
+    {
+      if ((pair = _sfFindPair(sf, ipair->key)) != NULL)
+      {
+        // Existing string, check for differences...
+        if (strcmp(pair->text, ipair->text))
+        {
+          // Yes
+          free(pair->text);
+          pair->text = strdup(ipair->text);
+          modified ++;
+        }
+      }
+      else if (!addnew)
+      {
+        // Ignore...
+        ignored ++;
+      }
+    }
+
+    if (addnew)
+    {
+      // Add new strings in a single pass...
+      _sf_rwlock_wrlock(sf->rwlock);
+      merged = _sfMergePairs(sf, isf, false, &added, &removed);
+      _sf_rwlock_unlock(sf->rwlock);
+
+      if (!merged)
+      {
+	sfPrintf(stderr, SFSTR("stringsutil: Unable to import '%s': %s"), filename, sfGetError(sf));
+	sfDelete(isf);
+	return (1);
+      }
+    }
+
+    sfDelete(isf);
+  }
+
+  // Finish up...
+  sfPrintf(stdout, SFSTR("stringsutil: %d added, %d ignored, %d modified."), added, ignored, modified);
+
+  if (added || modified)
+    return (write_strings(sf, sfname) ? 0 : 1);
+  else
+    return (0);
+}
+
+
+//
+// 'json_getc()' - Get the next character from a JSON response.
+//
+
+static int				// O - Character or `-1` at the end of the response
+json_getc(json_reader_t *jr)		// I - JSON reader
+{
+  int	ch;				// Current character
+
+
+  if ((ch = json_peek(jr)) >= 0)
+    jr->bufptr ++;
+
+  return (ch);
+}
+
+
+//
+// 'json_peek()' - Look at the next character in a JSON response.
+//
+// The read buffer is refilled from the connection as needed, so responses of
+// any size are parsed without first copying them into memory.
+//
+
+static int				// O - Character or `-1` at the end of the response
+json_peek(json_reader_t *jr)		// I - JSON reader
+{
+  ssize_t	bytes;			// Bytes read
+
+
+  if (jr->bufptr >= jr->bufend)
+  {
+    if ((bytes = httpRead(jr->http, jr->buffer, sizeof(jr->buffer))) <= 0)
+      return (-1);
+
+    jr->bufptr = jr->buffer;
+    jr->bufend = jr->buffer + bytes;
+  }
+
+  return (*(jr->bufptr) & 255);
+}
+
+
+//
+// 'json_read_hex()' - Read the four hex digits of a "\uXXXX" escape.
+//
+
+static int				// O - Character value or `-1` on error
+json_read_hex(json_reader_t *jr)	// I - JSON reader
+{
+  int	i,				// Looping var
+	ch,				// Current character
+	value = 0;			// Character value
+
+
+  for (i = 0; i < 4; i ++)
+  {
+    if ((ch = json_getc(jr)) < 0 || !isxdigit(ch))
+      return (-1);
+
+    if (isdigit(ch))
+      value = (value << 4) | (ch - '0');
+    else
+      value = (value << 4) | (tolower(ch) - 'a' + 10);
+  }
+
+  return (value);
+}
+
+
+//
+// 'json_read_string()' - Read a quoted string from a JSON response.
+//
+// The string is unescaped into "*buffer", which is grown as needed and reused
+// between calls.  If "buffer" is `NULL` the string is skipped.
+//
+
+static bool				// O - `true` on success, `false` on error
+json_read_string(json_reader_t *jr,	// I  - JSON reader
+                 char          **buffer,// IO - String buffer
+                 size_t        *bufsize)// IO - Size of string buffer
+{
+  int		ch,			// Current character
+		low;			// Low surrogate
+  bool		escaped;		// Escaped character?
+  size_t	len = 0;		// Length of string
+  char		*temp;			// New buffer
+
+
+  if (json_getc(jr) != '\"')
+    return (false);
+
+  while ((ch = json_getc(jr)) != '\"')
+  {
+    if (ch < 0)
+      return (false);
+
+    escaped = ch == '\\';
+
+    if (escaped)
+    {
+      // "\something" is an escaped character...
+      switch (ch = json_getc(jr))
+      {
+        case '\\' :
+        case '\"' :
+        case '/' :
+            break;
+        case 'b' :
+            ch = 0x08;
+            break;
+        case 'f' :
+            ch = 0x0c;
+            break;
+        case 'n' :
+            ch = 0x0a;
+            break;
+        case 'r' :
+            ch = 0x0d;
+            break;
+        case 't' :
+            ch = 0x09;
+            break;
+        case 'u' :
+            if ((ch = json_read_hex(jr)) < 0)
+              return (false);
+
+            if (ch >= 0xd800 && ch < 0xdc00)
+            {
+              // UTF-16 surrogate pair...
+              if (json_getc(jr) != '\\' || json_getc(jr) != 'u' || (low = json_read_hex(jr)) < 0xdc00 || low >= 0xe000)
+                return (false);
+
+              ch = 0x10000 + ((ch - 0xd800) << 10) + (low - 0xdc00);
+            }
+            break;
+        default :
+            return (false);
+      }
+    }
+
+    if (!buffer || !ch)
+      continue;
+
+    // Make room for the UTF-8 encoding of the character and the nul...
+    if ((len + 5) > *bufsize)
+    {
+      if ((temp = realloc(*buffer, *bufsize + 1024 + len)) == NULL)
+        return (false);
+
+      *buffer  = temp;
+      *bufsize = *bufsize + 1024 + len;
+    }
+
+    if (escaped)
+    {
+      // Escaped character...
+      if (ch < 0x80)
+      {
+        // ASCII
+        (*buffer)[len ++] = (char)ch;
+      }
+      else if (ch < 0x800)
+      {
+        // 2-byte UTF-8
+        (*buffer)[len ++] = (char)(0xc0 | (ch >> 6));
+        (*buffer)[len ++] = (char)(0x80 | (ch & 0x3f));
+      }
+      else if (ch < 0x10000)
+      {
+        // 3-byte UTF-8
+        (*buffer)[len ++] = (char)(0xe0 | (ch >> 12));
+        (*buffer)[len ++] = (char)(0x80 | ((ch >> 6) & 0x3f));
+        (*buffer)[len ++] = (char)(0x80 | (ch & 0x3f));
+      }
+      else
+      {
+        // 4-byte UTF-8
+        (*buffer)[len ++] = (char)(0xf0 | (ch >> 18));
+        (*buffer)[len ++] = (char)(0x80 | ((ch >> 12) & 0x3f));
+        (*buffer)[len ++] = (char)(0x80 | ((ch >> 6) & 0x3f));
+        (*buffer)[len ++] = (char)(0x80 | (ch & 0x3f));
+      }
+    }
+    else
+    {
+      // Literal character or UTF-8 byte...
+      (*buffer)[len ++] = (char)ch;
+    }
+  }
+
+  if (buffer)
+  {
+    if (!*buffer)
+    {
+      if ((*buffer = malloc(1024)) == NULL)
+        return (false);
+
+      *bufsize = 1024;
+    }
+
+    (*buffer)[len] = '\0';
+  }
+
+  return (true);
+}
+
+
+//
+// 'json_skip_space()' - Skip whitespace in a JSON response.
+//
+
+static int				// O - Next character or `-1` at the end of the response
+json_skip_space(json_reader_t *jr)	// I - JSON reader
+{
+  int	ch;				// Current character
+
+
+  while ((ch = json_peek(jr)) >= 0 && isspace(ch))
+    jr->bufptr ++;
+
+  return (ch);
+}
+
+
+//
+// 'json_skip_value()' - Skip a value in a JSON response.
+//
+
+static bool				// O - `true` on success, `false` on error
+json_skip_value(json_reader_t *jr)	// I - JSON reader
+{
+  int	ch,				// Current character
+	depth = 0;			// Array/object nesting depth
+
+
+  do
+  {
+    if ((ch = json_skip_space(jr)) < 0)
+    {
+      return (false);
+    }
+    else if (ch == '\"')
+    {
+      if (!json_read_string(jr, NULL, NULL))
+        return (false);
+    }
+    else if (ch == '[' || ch == '{')
+    {
+      jr->bufptr ++;
+      depth ++;
+    }
+    else if (ch == ']' || ch == '}')
+    {
+      if (depth == 0)
+        return (false);
+
+      jr->bufptr ++;
+      depth --;
+    }
+    else if (ch == ',' || ch == ':')
+    {
+      if (depth == 0)
+        return (false);
+
+      jr->bufptr ++;
+    }
+    else if (isalnum(ch) || ch == '-')
+    {
+      // Number, boolean, etc.
+      while ((ch = json_peek(jr)) >= 0 && (isalnum(ch) || ch == '+' || ch == '-' || ch == '.'))
+        jr->bufptr ++;
+    }
+    else
+    {
+      // Invalid character, including nul...
+      return (false);
+    }
+  }
+  while (depth > 0);
+
+  return (true);
+}
+
+
+//
+// 'matching_formats()' - Determine whether the key and localized text strings have matching formats.
+//
+// The format signatures of the keys are computed once with `_sfCompileFormats`,
+// so only the localized text needs to be parsed.
+//
+
+static bool				// O - `true` if matching, `false` otherwise
+matching_formats(_sf_pair_t *pair,	// I - Pair with key string
+                 const char *text)	// I - Localized text
+{
+  char	sig[2048];			// Format signature of text
+
+
+  if (!strchr(text, '%'))
+    return (!pair->format);
+  else if (!_sfFormatSignature(text, sig, sizeof(sig)))
+    return (false);
+  else if (pair->format)
+    return (!strcmp(pair->format, sig));
+  else
+    return (!sig[0]);
+}
+
+
+//
+// 'merge_strings()' - Merge strings from another strings file.
+//
+
+static int				// O - Exit status
+merge_strings(sf_t       *sf,		// I - Strings
+              const char *sfname,	// I - Strings filename
+              const char *filename,	// I - Merge filename
+              bool       clean)		// I - Clean old strings?
+{
+  sf_t		*msf;			// Strings file to merge
+  bool		merged;			// Merged strings?
+  int		added,			// Number of added strings
+		removed;		// Number of removed strings
+
+
+  // Open the merge file...
+  msf = sfNew();
+  if (!sfLoadFile(msf, filename))
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to merge '%s': %s"), filename, sfGetError(msf));
+    sfDelete(msf);
+    return (1);
+  }
+
+  // Merge the sorted strings in a single pass...
+  _sf_rwlock_wrlock(sf->rwlock);
+  merged = _sfMergePairs(sf, msf, clean, &added, &removed);
+  _sf_rwlock_unlock(sf->rwlock);
+
+  if (!merged)
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to merge '%s': %s"), filename, sfGetError(sf));
+    sfDelete(msf);
+    return (1);
+  }
+
+  sfDelete(msf);
+
+  if (added || removed)
+  {
+    sfPrintf(stdout, SFSTR("stringsutil: Added %d string(s), removed %d string(s)."), added, removed);
+    return (write_strings(sf, sfname) ? 0 : 1);
+  }
+
+  return (0);
+}
+
+
+//
+// 'report_add_issue()' - Add an issue to a report.
+//
+
+static bool				// O - `true` on success, `false` on error
+report_add_issue(report_file_t *file,	// I - Report file
+                 bool          format,	// I - Format mismatch?
+                 const char    *key,	// I - Key string
+                 const char    *text)	// I - Base text string
+{
+  report_issue_t	*issue;		// New issue
+
+
+  if (file->num_issues >= file->alloc_issues)
+  {
+    if ((issue = realloc(file->issues, (file->alloc_issues + 256) * sizeof(report_issue_t))) == NULL)
+      return (false);
+
+    file->issues       = issue;
+    file->alloc_issues += 256;
+  }
+
+  issue         = file->issues + file->num_issues ++;
+  issue->format = format;
+  issue->key    = key;
+  issue->text   = text;
+
+  return (true);
+}
+
+
+//
+// 'report_file()' - Compare a strings file to the base strings.
+//
+// Both collections are sorted by key, so the comparison is a single pass over
+// both arrays.  Issues reference the base strings, which outlive the job.
+//
+
+static void
+report_file(report_job_t  *job,		// I - Report job
+            report_file_t *file)	// I - Report file
+{
+  sf_t		*rsf;			// Strings file to report
+  _sf_pair_t	*pair,			// Current base pair
+		*pend,			// End of base pairs
+		*rpair,			// Current report pair
+		*rend;			// End of report pairs
+  int		result;			// Result of comparison
+
+
+  // Open the report file...
+  rsf = sfNew();
+  if (!sfLoadFile(rsf, file->filename))
+  {
+    snprintf(file->error, sizeof(file->error), "%s", sfGetError(rsf));
+    sfDelete(rsf);
+    return;
+  }
+
+  file->loaded = true;
+
+  // Loop through both lists and check strings...
+  for (pair = job->sf->pairs, pend = pair + job->sf->num_pairs, rpair = rsf->pairs, rend = rpair + rsf->num_pairs; pair < pend || rpair < rend;)
+  {
+    if (pair >= pend)
+      result = 1;
+    else if (rpair >= rend)
+      result = -1;
+    else
+      result = strcmp(pair->key, rpair->key);
+
+    if (result < 0)
+    {
+      // New message that hasn't been merged...
+      file->missing ++;
+      pair ++;
+      continue;
+    }
+    else if (result > 0)
+    {
+      // Old message...
+      file->old ++;
+      rpair ++;
+      continue;
+    }
+
+    if (!matching_formats(pair, rpair->text))
+    {
+      file->errors ++;
+
+      if (!report_add_issue(file, true, pair->key, pair->text))
+        break;
+    }
+
+    if (strcmp(rpair->text, pair->text))
+    {
+      file->translated ++;
+    }
+    else
+    {
+      file->untranslated ++;
+
+      if (job->verbose && !report_add_issue(file, false, pair->key, pair->text))
+        break;
+    }
+
+    pair ++;
+    rpair ++;
+  }
+
+  if (pair < pend || rpair < rend)
+  {
+    file->loaded = false;
+    snprintf(file->error, sizeof(file->error), "%s", strerror(ENOMEM));
+  }
+
+  sfDelete(rsf);
+}
+
+
+//
+// 'report_strings()' - Report how many strings are translated.
+//
+// The strings files are compared to the base strings in parallel, and the
+// results are reported in order as text, CSV, or JSON.
+//
+
+static int				// O - Exit status
+report_strings(sf_t       *sf,		// I - Strings
+               int        num_files,	// I - Number of comparison files
+               const char *files[],	// I - Comparison filenames
+               int        num_jobs,	// I - Number of parallel jobs (0 = auto)
+               const char *format,	// I - Report format ("csv", "json", or "text")
+               bool       verbose)	// I - Be verbose?
+{
+  int		i,			// Looping var
+		status = 0;		// Exit status
+  report_job_t	job;			// Report job
+  report_file_t	*file;			// Current file
+  report_issue_t *issue;		// Current issue
+  size_t	count;			// Number of issues remaining
+  int		total;			// Total messages
+  bool		first = true,		// First file in output?
+		first_error;		// First error in output?
+  const char	*fptr;			// Pointer into filename
+  char		buffer[4096];		// Encoded JSON string
+#ifndef _WIN32
+  pthread_t	*threads = NULL;	// Report threads
+  int		num_threads = 0;	// Number of report threads
+#endif // !_WIN32
+
+
+  // Set up the report job...
+  memset(&job, 0, sizeof(job));
+
+  job.sf        = sf;
+  job.verbose   = verbose;
+  job.num_files = (size_t)num_files;
+
+  if ((job.files = calloc((size_t)num_files, sizeof(report_file_t))) == NULL)
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to allocate memory: %s"), strerror(errno));
+    return (1);
+  }
+
+  for (i = 0; i < num_files; i ++)
+    job.files[i].filename = files[i];
+
+  if (!_sfCompileFormats(sf))
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to allocate memory: %s"), strerror(errno));
+    free(job.files);
+    return (1);
+  }
+
+  // Start the report threads...
+#if !defined(_WIN32) && defined(_SC_NPROCESSORS_ONLN)
+  if (num_jobs < 1)
+    num_jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif // !_WIN32 && _SC_NPROCESSORS_ONLN
+
+  if (num_jobs > num_files)
+    num_jobs = num_files;
+
+#ifndef _WIN32
+  pthread_mutex_init(&job.mutex, NULL);
+
+  if (num_jobs > 1 && (threads = calloc((size_t)num_jobs - 1, sizeof(pthread_t))) != NULL)
+  {
+    for (; num_threads < (num_jobs - 1); num_threads ++)
+    {
+      if (pthread_create(threads + num_threads, NULL, (void *(*)(void *))report_thread, &job))
+        break;
+    }
+  }
+#endif // !_WIN32
+
+  report_thread(&job);
+
+#ifndef _WIN32
+  for (i = 0; i < num_threads; i ++)
+    pthread_join(threads[i], NULL);
+
+  free(threads);
+  pthread_mutex_destroy(&job.mutex);
+#endif // !_WIN32
+
+  // Show the results in order...
+  if (!strcmp(format, "csv"))
+    puts("filename,total,translated,untranslated,missing,old,errors");
+  else if (!strcmp(format, "json"))
+    putchar('[');
+
+  for (i = 0, file = job.files; i < num_files; i ++, file ++)
+  {
+    if (!file->loaded)
+    {
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to report on '%s': %s"), file->filename, file->error);
+      status = 1;
+      free(file->issues);
+      continue;
+    }
+
+    for (count = file->num_issues, issue = file->issues; count > 0; count --, issue ++)
+    {
+      if (issue->format)
+        sfPrintf(stderr, SFSTR("stringsutil: Translated format string does not match '%s' in '%s'."), issue->key, file->filename);
+      else
+        sfPrintf(stderr, SFSTR("stringsutil: '%s' is not translated in '%s'."), issue->text, file->filename);
+    }
+
+    total = file->translated + file->missing + file->untranslated;
+
+    if (!strcmp(format, "csv"))
+    {
+      // filename,total,translated,untranslated,missing,old,errors
+      putchar('\"');
+      for (fptr = file->filename; *fptr; fptr ++)
+      {
+        if (*fptr == '\"')
+          putchar('\"');
+        putchar(*fptr);
+      }
+      printf("\",%d,%d,%d,%d,%d,%d\n", total, file->translated, file->untranslated, file->missing, file->old, file->errors);
+    }
+    else if (!strcmp(format, "json"))
+    {
+      // {"filename":"...","total":N,...,"errors":["key",...]}
+      encode_string(file->filename, buffer, buffer + sizeof(buffer) - 1);
+      printf("%s\n{\"filename\":%s,\"total\":%d,\"translated\":%d,\"untranslated\":%d,\"missing\":%d,\"old\":%d,\"errors\":[", first ? "" : ",", buffer, total, file->translated, file->untranslated, file->missing, file->old);
+
+      for (count = file->num_issues, issue = file->issues, first_error = true; count > 0; count --, issue ++)
+      {
+        if (!issue->format)
+          continue;
+
+        encode_string(issue->key, buffer, buffer + sizeof(buffer) - 1);
+        printf("%s%s", first_error ? "" : ",", buffer);
+        first_error = false;
+      }
+
+      fputs("]}", stdout);
+      first = false;
+    }
+    else
+    {
+      if (file->missing || file->old)
+	sfPrintf(stdout, SFSTR("stringsutil: '%s' needs to be merged, %d missing and %d old string(s)."), file->filename, file->missing, file->old);
+
+      if (total == 0)
+	sfPrintf(stdout, SFSTR("stringsutil: No strings in '%s'."), file->filename);
+      else
+	sfPrintf(stdout, SFSTR("stringsutil: %d string(s), %d (%d%%) translated, %d (%d%%) untranslated in '%s'."), total, file->translated, 100 * file->translated / total, file->untranslated + file->missing, 100 * (file->untranslated + file->missing) / total, file->filename);
+    }
+
+    if (file->untranslated > (total / 2) || file->errors > 0)
+      status = 1;
+
+    free(file->issues);
+  }
+
+  if (!strcmp(format, "json"))
+    puts("\n]");
+
+  free(job.files);
+
+  return (status);
+}
+
+
+//
+// 'report_thread()' - Report on strings files until the job is done.
+//
+
+static void *				// O - Thread exit status (unused)
+report_thread(report_job_t *job)	// I - Report job
+{
+  report_file_t	*file;			// Current file
+
+
+  for (;;)
+  {
+#ifndef _WIN32
+    pthread_mutex_lock(&job->mutex);
+#endif // !_WIN32
+
+    if (job->next_file < job->num_files)
+      file = job->files + job->next_file ++;
+    else
+      file = NULL;
+
+#ifndef _WIN32
+    pthread_mutex_unlock(&job->mutex);
+#endif // !_WIN32
+
+    if (!file)
+      break;
+
+    report_file(job, file);
+  }
+
+  return (NULL);
+}
+
+
+//
+// 'scan_add_file()' - Add a source file to a scan job.
+//
+// The file is queued for the scan threads.  If "error" is non-zero, the file
+// is not scanned and the error is reported in order with any other errors.
+//
+
+static bool				// O - `true` on success, `false` on error
+scan_add_file(scan_job_t *job,		// I - Scan job
+              const char *filename,	// I - Filename
+              int        error)		// I - `errno` value or 0 for none
+{
+  scan_file_t	*file,			// New file
+		**files;		// New files array
+
+
+  // Create the file...
+  if ((file = calloc(1, sizeof(scan_file_t))) == NULL)
+    return (false);
+
+  if ((file->filename = strdup(filename)) == NULL)
+  {
+    free(file);
+    return (false);
+  }
+
+  file->error = error;
+
+  if (job->cache && job->cache->num_files > 0)
+    file->cached = bsearch(file, job->cache->files, job->cache->num_files, sizeof(scan_file_t), (int (*)(const void *, const void *))scan_compare_files);
+
+  // Queue it for the scan threads...
+#ifndef _WIN32
+  pthread_mutex_lock(&job->mutex);
+#endif // !_WIN32
+
+  if (job->num_files >= job->alloc_files)
+  {
+    if ((files = realloc(job->files, (job->alloc_files + 1024) * sizeof(scan_file_t *))) == NULL)
+    {
+#ifndef _WIN32
+      pthread_mutex_unlock(&job->mutex);
+#endif // !_WIN32
+
+      free(file->filename);
+      free(file);
+      return (false);
+    }
+
+    job->files       = files;
+    job->alloc_files += 1024;
+  }
+
+  job->files[job->num_files ++] = file;
+
+#ifndef _WIN32
+  pthread_cond_signal(&job->cond);
+  pthread_mutex_unlock(&job->mutex);
+#endif // !_WIN32
+
+  return (true);
+}
+
+
+//
+// 'scan_add_path()' - Add a source file or directory to a scan job.
+//
+// Directories are walked recursively when "walk" is `true`, otherwise they
+// are queued as files and reported as errors.
+//
+
+static bool				// O - `true` on success, `false` on error
+scan_add_path(scan_job_t *job,		// I - Scan job
+              const char *path,		// I - File or directory
+              bool       walk)		// I - Walk directories?
+{
+  struct stat	fileinfo;		// File information
+
+
+  if (walk && !stat(path, &fileinfo) && S_ISDIR(fileinfo.st_mode))
+    return (scan_walk(job, path));
+  else
+    return (scan_add_file(job, path, 0));
+}
+
+
+//
+// 'scan_add_string()' - Add a candidate string found in a source file.
+//
+
+static bool				// O - `true` on success, `false` on error
+scan_add_string(scan_file_t *file,	// I - Source file
+                const char  *text,	// I - Text string
+                const char  *comment)	// I - Comment string or `NULL`
+{
+  scan_string_t	*string;		// New string
+
+
+  if (file->num_strings >= file->alloc_strings)
+  {
+    if ((string = realloc(file->strings, (file->alloc_strings + 32) * sizeof(scan_string_t))) == NULL)
+      return (false);
+
+    file->strings       = string;
+    file->alloc_strings += 32;
+  }
+
+  string          = file->strings + file->num_strings;
+  string->text    = strdup(text);
+  string->comment = comment && *comment ? strdup(comment) : NULL;
+  string->seq     = 0;
+
+  if (!string->text || (!string->comment && comment && *comment))
+  {
+    free(string->text);
+    free(string->comment);
+    return (false);
+  }
+
+  file->num_strings ++;
+
+  return (true);
+}
+
+
+//
+// 'scan_build_names()' - Build the search automaton for the function names.
+//
+// Each name is "NAME" or "NAME:ARG", where "ARG" is the number of the string
+// argument (default 1).  The names are compiled into an Aho-Corasick automaton
+// with a full transition table so that all names are found in a single pass
+// over each file with one table lookup per byte.
+//
+
+static bool				// O - `true` on success, `false` on error
+scan_build_names(
+    scan_job_t         *job,		// I - Scan job
+    const char * const *funcnames)	// I - `NULL`-terminated function names
+{
+  size_t	i,			// Looping var
+		len,			// Length of names
+		num_states,		// Number of states
+		qhead,			// Head of queue
+		qtail;			// Tail of queue
+  int		c,			// Current character
+		state,			// Current state
+		next,			// Next state
+		*fails = NULL,		// Failure links
+		*queue = NULL;		// Breadth-first queue
+  const char	*colon,			// Colon in name
+		*ptr;			// Pointer into name
+  scan_name_t	*name;			// Current name
+  char		*spec;			// Pointer into cache key
+
+
+  // Parse the names...
+  for (len = 1, job->num_names = 0; funcnames[job->num_names]; job->num_names ++)
+    len += strlen(funcnames[job->num_names]) + 1;
+
+  if ((job->names = calloc(job->num_names, sizeof(scan_name_t))) == NULL || (spec = calloc(1, len)) == NULL)
+    return (false);
+
+  job->funcnames = spec;
+
+  for (i = 0, name = job->names, len = 1; i < job->num_names; i ++, name ++)
+  {
+    // Copy the name for the cache key...
+    if (i > 0)
+      *spec++ = ',';
+
+    strcpy(spec, funcnames[i]);
+    spec += strlen(spec);
+
+    // Split "NAME:ARG"...
+    name->arg = 1;
+
+    if ((colon = strrchr(funcnames[i], ':')) != NULL && colon[1] && strspn(colon + 1, "0123456789") == strlen(colon + 1) && atoi(colon + 1) > 0)
+    {
+      name->arg  = atoi(colon + 1);
+      name->name = strndup(funcnames[i], (size_t)(colon - funcnames[i]));
+    }
+    else
+    {
+      name->name = strdup(funcnames[i]);
+    }
+
+    if (!name->name)
+      return (false);
+
+    if ((name->len = strlen(name->name)) == 0)
+    {
+      errno = EINVAL;
+      return (false);
+    }
+
+    len += name->len;
+  }
+
+  // Build the trie...
+  if ((job->states = malloc(len * 256 * sizeof(int))) == NULL || (job->matches = malloc(len * sizeof(int))) == NULL || (job->outputs = malloc(len * sizeof(int))) == NULL || (job->dicts = malloc(len * sizeof(int))) == NULL || (fails = calloc(len, sizeof(int))) == NULL || (queue = calloc(len, sizeof(int))) == NULL)
+  {
+    free(fails);
+    return (false);
+  }
+
+  memset(job->states, -1, len * 256 * sizeof(int));
+  job->matches[0] = -1;
+  job->dicts[0]   = -1;
+  num_states      = 1;
+
+  for (i = 0, name = job->names; i < job->num_names; i ++, name ++)
+  {
+    for (state = 0, ptr = name->name; *ptr; ptr ++)
+    {
+      c = *ptr & 255;
+
+      if ((next = job->states[state * 256 + c]) < 0)
+      {
+        next                         = (int)num_states ++;
+        job->states[state * 256 + c] = next;
+        job->matches[next]           = -1;
+        job->dicts[next]             = -1;
+      }
+
+      state = next;
+    }
+
+    // Chain names that only differ in the argument number...
+    name->next = -1;
+
+    if ((next = job->matches[state]) < 0)
+    {
+      job->matches[state] = (int)i;
+    }
+    else
+    {
+      while (job->names[next].next >= 0)
+        next = job->names[next].next;
+
+      job->names[next].next = (int)i;
+    }
+  }
+
+  job->num_states = num_states;
+
+  // Compute the failure links and fill in the missing transitions...
+  for (c = 0, qtail = 0; c < 256; c ++)
+  {
+    if ((next = job->states[c]) < 0)
+    {
+      job->states[c] = 0;
+    }
+    else
+    {
+      fails[next]    = 0;
+      queue[qtail ++] = next;
+    }
+  }
+
+  for (qhead = 0; qhead < qtail; qhead ++)
+  {
+    state = queue[qhead];
+
+    for (c = 0; c < 256; c ++)
+    {
+      if ((next = job->states[state * 256 + c]) < 0)
+      {
+        job->states[state * 256 + c] = job->states[fails[state] * 256 + c];
+      }
+      else
+      {
+        fails[next]     = job->states[fails[state] * 256 + c];
+        job->dicts[next] = job->matches[fails[next]] >= 0 ? fails[next] : job->dicts[fails[next]];
+        queue[qtail ++]  = next;
+      }
+    }
+  }
+
+  free(fails);
+  free(queue);
+
+  // Premultiply the transitions and collect the first match for each state...
+  for (i = 0; i < (num_states * 256); i ++)
+    job->states[i] *= 256;
+
+  for (i = 0; i < num_states; i ++)
+    job->outputs[i] = job->matches[i] >= 0 ? (int)i : job->dicts[i];
+
+  // Find the common first character, if any, so that the root state can be
+  // skipped using memchr...
+  for (c = 0, job->first = -1; c < 256; c ++)
+  {
+    if (job->states[c] == 0)
+      continue;
+
+    if (job->first < 0)
+    {
+      job->first = c;
+    }
+    else
+    {
+      job->first = -1;
+      break;
+    }
+  }
+
+  return (true);
+}
+
+
+//
+// 'scan_call()' - Scan a localization function call for its string.
+//
+// "ptr" points just after the opening parenthesis.  The string argument may be
+// preceded by a C comment, and may consist of several concatenated string
+// literals.
+//
+
+static bool				// O - `true` on success, `false` on error
+scan_call(scan_file_t *file,		// I - Source file
+          const char  *ptr,		// I - Pointer after "FUNCNAME("
+          const char  *end,		// I - End of source
+          int         arg)		// I - String argument number
+{
+  const char	*cstart = NULL,		// Start of comment
+		*cend = NULL;		// End of comment
+  char		comment[1024],		// Comment string (if any)
+		text[1024];		// Text string
+  size_t	len = 0;		// Length of comment/text string
+  bool		valid = false;		// Valid string?
+
+
+  // Skip to the string argument...
+  for (; arg > 1; arg --)
+  {
+    if ((ptr = scan_skip_arg(ptr, end)) == NULL)
+      return (true);
+  }
+
+  // Look for comment and text...
+  if ((ptr = scan_skip(ptr, end, &cstart, &cend)) == NULL)
+    return (true);
+
+  while (ptr < end && *ptr == '\"')
+  {
+    // Copy a string literal...
+    for (ptr ++; ptr < end && *ptr != '\"' && *ptr != '\n'; ptr ++)
+    {
+      int ch = *ptr;			// Current character
+
+      if (ch == '\\')
+      {
+        // Handle C escape
+        if (++ ptr >= end)
+          break;
+
+        if (*ptr == '\n')
+          continue;			// Line continuation
+        else if (*ptr == 'n')
+          ch = '\n';
+        else if (*ptr == 'r')
+          ch = '\r';
+        else if (*ptr == 't')
+          ch = '\t';
+        else if (*ptr >= '0' && *ptr <= '3' && (end - ptr) > 2 && ptr[1] >= '0' && ptr[1] <= '7' && ptr[2] >= '0' && ptr[2] <= '7')
+        {
+          ch = ((*ptr - '0') << 6) | ((ptr[1] - '0') << 3) | (ptr[2] - '0');
+          ptr += 2;
+        }
+        else
+          ch = *ptr;
+      }
+
+      if (len < (sizeof(text) - 1))
+        text[len ++] = (char)ch;
+    }
+
+    if (ptr >= end || *ptr != '\"')
+      return (true);			// Unterminated string
+
+    // Skip whitespace and comments to the next token...
+    if ((ptr = scan_skip(ptr + 1, end, NULL, NULL)) == NULL)
+      return (true);
+
+    valid = ptr < end && (*ptr == ')' || *ptr == ',');
+  }
+
+  if (!valid)
+    return (true);
+
+  // Save the string...
+  text[len] = '\0';
+
+  if (cstart)
+  {
+    while (cstart < cend && isspace(*cstart & 255))
+      cstart ++;
+    while (cend > cstart && isspace(cend[-1] & 255))
+      cend --;
+
+    if ((len = (size_t)(cend - cstart)) > (sizeof(comment) - 1))
+      len = sizeof(comment) - 1;
+
+    memcpy(comment, cstart, len);
+    comment[len] = '\0';
+  }
+
+  if (!scan_add_string(file, text, cstart ? comment : NULL))
+  {
+    file->error = ENOMEM;
+    return (false);
+  }
+
+  return (true);
+}
+
+
+//
+// 'scan_compare_files()' - Compare two scan cache files by name.
+//
+
+static int				// O - Result of comparison
+scan_compare_files(scan_file_t *a,	// I - First file
+                   scan_file_t *b)	// I - Second file
+{
+  return (strcmp(a->filename, b->filename));
+}
+
+
+//
+// 'scan_compare_names()' - Compare two directory entry names.
+//
+
+static int				// O - Result of comparison
+scan_compare_names(char **a,		// I - First name
+                   char **b)		// I - Second name
+{
+  return (strcmp(*a, *b));
+}
+
+
+//
+// 'scan_compare_paths()' - Compare two scan job files by name.
+//
+
+static int				// O - Result of comparison
+scan_compare_paths(scan_file_t **a,	// I - First file
+                   scan_file_t **b)	// I - Second file
+{
+  return (strcmp((*a)->filename, (*b)->filename));
+}
+
+
+//
+// 'scan_compare_strings()' - Compare two candidate strings.
+//
+// Candidates with the same text are ordered by their position in the
+// sequential scan so that the first occurrence wins.
+//
+
+static int				// O - Result of comparison
+scan_compare_strings(
+    scan_string_t **a,			// I - First string
+    scan_string_t **b)			// I - Second string
+{
+  int	result;				// Result of comparison
+
+
+  if ((result = strcmp((*a)->text, (*b)->text)) != 0)
+    return (result);
+  else if ((*a)->seq < (*b)->seq)
+    return (-1);
+  else
+    return ((*a)->seq > (*b)->seq);
+}
+
+
+//
+// 'scan_copy_strings()' - Copy cached strings to a source file.
+//
+
+static void
+scan_copy_strings(
+    scan_file_t       *file,		// I - Source file
+    const scan_file_t *cached)		// I - Cached scan results
+{
+  size_t		i;		// Looping var
+  const scan_string_t	*string;	// Current string
+
+
+  for (i = cached->num_strings, string = cached->strings; i > 0; i --, string ++)
+  {
+    if (!scan_add_string(file, string->text, string->comment))
+    {
+      file->error = ENOMEM;
+      break;
+    }
+  }
+}
+
+
+//
+// 'scan_file()' - Scan a single source file for localization strings.
+//
+// The file is mapped into memory and searched for all of the function names
+// in a single pass using the automaton built by scan_build_names, skipping
+// ahead with memchr when all names start with the same character.  For each
+// "FUNCNAME(" found, scan_call tokenizes the call so that calls that span
+// multiple lines and concatenated literals like `"a" "b"` are found.
+//
+// All strings found are collected in the scan_file_t structure so that
+// multiple files can be scanned at the same time.  If the file has cached
+// scan results and its size and modification time (or the hash of its
+// contents) are unchanged, the cached strings are used instead.
+//
+
+static void
+scan_file(scan_job_t  *job,		// I - Scan job
+          scan_file_t *file)		// I - Source file
+{
+  const scan_file_t *cached = file->cached;
+					// Cached scan results, if any
+  int		fd;			// File descriptor
+  struct stat	fileinfo;		// File information
+  size_t	datasize;		// Size of file data
+  char		*data;			// File data
+  const char	*dataptr,		// Pointer into file data
+		*dataend;		// End of file data
+  const int	*states = job->states;	// Automaton transitions
+  int		state,			// Current automaton state
+		match;			// Matching state
+  uint64_t	hash;			// Hash of file contents
+
+
+  // See if the file has changed since the cache was written...
+  if (cached && !stat(file->filename, &fileinfo) && cached->size == (long long)fileinfo.st_size && cached->mtime == (long long)fileinfo.st_mtime && cached->mtime < job->cache_mtime)
+  {
+    // No, use the cached strings...
+    file->size  = cached->size;
+    file->mtime = cached->mtime;
+    file->hash  = cached->hash;
+    scan_copy_strings(file, cached);
+    return;
+  }
+
+  // Map the file into memory...
+  if ((fd = open(file->filename, O_RDONLY)) < 0)
+  {
+    file->error = errno;
+    return;
+  }
+
+  if (fstat(fd, &fileinfo))
+  {
+    file->error = errno;
+    close(fd);
+    return;
+  }
+
+  file->size    = (long long)fileinfo.st_size;
+  file->mtime   = (long long)fileinfo.st_mtime;
+  file->scanned = true;
+
+  if ((datasize = (size_t)fileinfo.st_size) == 0)
+  {
+    close(fd);
+    return;
+  }
+
+#ifdef _WIN32
+  if ((data = malloc(datasize)) == NULL)
+  {
+    file->error = errno;
+    close(fd);
+    return;
+  }
+
+  if (read(fd, data, (unsigned)datasize) != (int)datasize)
+  {
+    file->error = errno ? errno : EIO;
+    close(fd);
+    free(data);
+    return;
+  }
+
+#else
+  if ((data = mmap(NULL, datasize, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+  {
+    file->error = errno;
+    close(fd);
+    return;
+  }
+#endif // _WIN32
+
+  close(fd);
+
+  dataend = data + datasize;
+
+  if (job->use_cache)
+  {
+    // Compare the hash of the contents with the cached scan results...
+    uint64_t	word;			// Current word
+
+    for (hash = 14695981039346656037ULL, dataptr = data; (dataend - dataptr) >= 8; dataptr += 8)
+    {
+      memcpy(&word, dataptr, sizeof(word));
+      hash = ((hash ^ word) * 1099511628211ULL);
+      hash ^= hash >> 29;
+    }
+
+    for (; dataptr < dataend; dataptr ++)
+      hash = (hash ^ (uint8_t)*dataptr) * 1099511628211ULL;
+
+    file->hash = hash;
+
+    if (cached && cached->size == file->size && cached->hash == hash)
+    {
+      file->scanned = false;
+      scan_copy_strings(file, cached);
+      goto done;
+    }
+  }
+
+  // Look for the function invocations...
+  for (dataptr = data, state = 0; dataptr < dataend; dataptr ++)
+  {
+    if (state == 0)
+    {
+      // Skip characters that don't start a name...
+      if (job->first >= 0)
+      {
+        if ((dataptr = memchr(dataptr, job->first, (size_t)(dataend - dataptr))) == NULL)
+          break;
+      }
+      else
+      {
+        while (dataptr < dataend && !states[*dataptr & 255])
+          dataptr ++;
+
+        if (dataptr >= dataend)
+          break;
+      }
+    }
+
+    state = states[state + (*dataptr & 255)];
+
+    if ((match = job->outputs[state / 256]) < 0 || (dataend - dataptr) < 2 || dataptr[1] != '(')
+      continue;
+
+    for (; match > 0; match = job->dicts[match])
+    {
+      // Found "FUNCNAME(", check that the name is a separate token...
+      const scan_name_t *name = job->names + job->matches[match];
+					// Matching name
+      const char *start = dataptr + 1 - name->len;
+					// Start of name
+
+      if (start > data && (!start[-1] || !strchr(" \t\r\n(,{", start[-1])))
+        continue;
+
+      for (;;)
+      {
+        if (!scan_call(file, dataptr + 2, dataend, name->arg))
+          goto done;
+
+        if (name->next < 0)
+          break;
+
+        name = job->names + name->next;
+      }
+    }
+  }
+
+  // Unmap the file and return...
+  done:
+
+#ifdef _WIN32
+  free(data);
+#else
+  munmap(data, datasize);
+#endif // _WIN32
+}
+
+
+//
+// 'scan_files()' - Scan source files for localization strings.
+//
+// Each argument is a source file, a directory that is walked recursively, an
+// "@LISTFILE" containing one file or directory per line, or "-" to read the
+// list from the standard input.  Directory entries are filtered using the
+// include and exclude patterns.
+//
+// The files are scanned by a pool of "num_jobs" threads, each of which collects
+// candidate strings locally, while the main thread walks the directories and
+// list files.  The candidates are then merged into the strings file in the
+// same order as a sequential scan so that the output does not depend on the
+// number of jobs.
+//
+// When "use_cache" is `true`, the strings found in each file are saved in a
+// scan cache ("FILENAME.strings.cache") and unchanged files are not scanned
+// again on the next run.
+//
+// When "rewrite" is `true`, the strings file is written even if no new strings
+// were found.
+//
+
+static int				// O - Exit status
+scan_files(sf_t       *sf,		// I - Strings
+           const char *sfname,		// I - Strings filename
+           const char * const *funcnames,// I - Localization function names
+           int        num_jobs,		// I - Number of parallel jobs or 0 for the number of CPUs
+           bool       use_cache,	// I - Use the scan cache?
+           bool       rewrite,		// I - Write the strings file even if there are no new strings?
+           const char * const *includes,// I - Include patterns or empty for C/C++ source files
+           const char * const *excludes,// I - Exclude patterns
+           int        num_files,	// I - Number of files
+           const char *files[])		// I - Files
+{
+  int		i;			// Looping var
+  int		status = 0;		// Exit status
+  int		changes = 0,		// How many added strings?
+		scanned = 0;		// How many files were scanned?
+  bool		added = true;		// Were all files added?
+  scan_job_t	job;			// Scan job
+  scan_cache_t	cache;			// Scan cache
+  char		cachename[1024];	// Scan cache filename
+  long long	scan_mtime = (long long)time(NULL);
+					// Time of this scan
+  scan_file_t	*file;			// Current file
+  scan_string_t	*string,		// Current string
+		**candidates = NULL;	// Candidate strings
+  size_t	j, k,			// Looping vars
+		num_candidates = 0;	// Number of candidate strings
+#ifndef _WIN32
+  pthread_t	*threads = NULL;	// Worker threads
+  int		num_threads = 0;	// Number of worker threads
+#endif // !_WIN32
+  static const char * const sources[] =	// Default include patterns
+  {
+    "*.c", "*.cc", "*.cpp", "*.cxx", "*.h", "*.hh", "*.hpp", "*.m", "*.mm", NULL
+  };
+
+
+  // Setup the scan job...
+  memset(&job, 0, sizeof(job));
+  memset(&cache, 0, sizeof(cache));
+
+  job.includes  = includes[0] ? includes : sources;
+  job.excludes  = excludes;
+  job.use_cache = use_cache;
+
+  if (!scan_build_names(&job, funcnames))
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to scan source files: %s"), strerror(errno));
+    status = 1;
+    goto done;
+  }
+
+  if (use_cache)
+  {
+    snprintf(cachename, sizeof(cachename), "%s.cache", sfname);
+
+    if (scan_load_cache(&cache, cachename, job.funcnames))
+    {
+      job.cache       = &cache;
+      job.cache_mtime = cache.mtime;
+    }
+  }
+
+  // Start the scan threads...
+#if !defined(_WIN32) && defined(_SC_NPROCESSORS_ONLN)
+  if (num_jobs < 1)
+    num_jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif // !_WIN32 && _SC_NPROCESSORS_ONLN
+
+#ifndef _WIN32
+  pthread_mutex_init(&job.mutex, NULL);
+  pthread_cond_init(&job.cond, NULL);
+
+  if (num_jobs > 1 && (threads = calloc((size_t)num_jobs - 1, sizeof(pthread_t))) != NULL)
+  {
+    for (; num_threads < (num_jobs - 1); num_threads ++)
+    {
+      if (pthread_create(threads + num_threads, NULL, (void *(*)(void *))scan_thread, &job))
+        break;
+    }
+  }
+#endif // !_WIN32
+
+  // Add the files while the threads scan them...
+  for (i = 0; i < num_files && added; i ++)
+  {
+    if (!strcmp(files[i], "-"))
+      added = scan_read_list(&job, NULL);
+    else if (files[i][0] == '@')
+      added = scan_read_list(&job, files[i] + 1);
+    else
+      added = scan_add_path(&job, files[i], true);
+  }
+
+#ifndef _WIN32
+  pthread_mutex_lock(&job.mutex);
+#endif // !_WIN32
+
+  job.done = true;
+
+  if (!added)
+    job.next_file = job.num_files;	// Don't scan any more files
+
+#ifndef _WIN32
+  pthread_cond_broadcast(&job.cond);
+  pthread_mutex_unlock(&job.mutex);
+#endif // !_WIN32
+
+  // Help scan the remaining files and then wait for the threads...
+  scan_thread(&job);
+
+#ifndef _WIN32
+  for (i = 0; i < num_threads; i ++)
+    pthread_join(threads[i], NULL);
+
+  free(threads);
+  pthread_cond_destroy(&job.cond);
+  pthread_mutex_destroy(&job.mutex);
+#endif // !_WIN32
+
+  if (!added)
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to scan source files: %s"), strerror(errno));
+    status = 1;
+    goto done;
+  }
+
+  // Report the first error, if any...
+  for (j = 0; j < job.num_files; j ++)
+  {
+    file = job.files[j];
+
+    if (file->error)
+    {
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to open source file '%s': %s"), file->filename, strerror(file->error));
+      status = 1;
+      goto done;
+    }
+
+    if (file->scanned)
+      scanned ++;
+
+    num_candidates += file->num_strings;
+  }
+
+  // Merge the new strings in sequential order, keeping the first occurrence
+  // of each string...
+  if (num_candidates > 0)
+  {
+    if ((candidates = calloc(num_candidates, sizeof(scan_string_t *))) == NULL)
+    {
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to scan source files: %s"), strerror(errno));
+      status = 1;
+      goto done;
+    }
+
+    for (j = 0, num_candidates = 0; j < job.num_files; j ++)
+    {
+      for (k = job.files[j]->num_strings, string = job.files[j]->strings; k > 0; k --, string ++)
+      {
+        string->seq = num_candidates;
+
+        if (!sfHasString(sf, string->text))
+          candidates[num_candidates ++] = string;
+      }
+    }
+
+    qsort(candidates, num_candidates, sizeof(scan_string_t *), (int (*)(const void *, const void *))scan_compare_strings);
+
+    _sf_rwlock_wrlock(sf->rwlock);
+
+    for (j = 0; j < num_candidates; j ++)
+    {
+      if (j > 0 && !strcmp(candidates[j]->text, candidates[j - 1]->text))
+        continue;
+
+      if (!_sfAddPair(sf, candidates[j]->text, candidates[j]->text, candidates[j]->comment))
+        break;
+
+      changes ++;
+    }
+
+    _sfSortPairs(sf);
+
+    _sf_rwlock_unlock(sf->rwlock);
+
+    if (j < num_candidates)
+    {
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to scan source files: %s"), sfGetError(sf));
+      status = 1;
+      goto done;
+    }
+  }
+
+  // Write out any changes as needed...
+  if (use_cache)
+    sfPrintf(stdout, SFSTR("stringsutil: Scanned %d of %d files."), scanned, (int)job.num_files);
+
+  if (changes == 0)
+    sfPuts(stdout, SFSTR("stringsutil: No new strings."));
+  else if (changes == 1)
+    sfPuts(stdout, SFSTR("stringsutil: 1 new string."));
+  else
+    sfPrintf(stdout, SFSTR("stringsutil: %d new strings."), changes);
+
+  if ((changes > 0 || rewrite) && !write_strings(sf, sfname))
+  {
+    status = 1;
+    goto done;
+  }
+
+  // Update the scan cache...
+  if (use_cache && (scanned > 0 || cache.num_files != job.num_files) && !scan_save_cache(&job, cachename, scan_mtime))
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to write scan cache '%s': %s"), cachename, strerror(errno));
+
+  // Free memory and return...
+  done:
+
+  free(candidates);
+
+  for (j = 0; j < job.num_files; j ++)
+  {
+    file = job.files[j];
+
+    for (k = file->num_strings, string = file->strings; k > 0; k --, string ++)
+    {
+      free(string->text);
+      free(string->comment);
+    }
+
+    free(file->strings);
+    free(file->filename);
+    free(file);
+  }
+
+  free(job.files);
+
+  for (j = 0; j < job.num_names; j ++)
+    free(job.names[j].name);
+
+  free(job.names);
+  free((char *)job.funcnames);
+  free(job.states);
+  free(job.matches);
+  free(job.outputs);
+  free(job.dicts);
+
+  free(cache.files);
+  free(cache.strings);
+  free(cache.data);
+
+  return (status);
+}
+
+
+//
+// 'scan_load_cache()' - Load the scan cache.
+//
+// The scan cache is a text file containing length-prefixed strings:
+//
+//   SFSCAN 1 MTIME FUNCNAMES-LENGTH NUM-FILES NUM-STRINGS\n
+//   FUNCNAMES\n
+//
+// followed by each file:
+//
+//   SIZE MTIME HASH NUM-STRINGS FILENAME-LENGTH\n
+//   FILENAME\n
+//
+// and each string in the file:
+//
+//   TEXT-LENGTH COMMENT-LENGTH\n
+//   TEXT\n
+//   COMMENT\n			(only if COMMENT-LENGTH > 0)
+//
+// The files are sorted by name.  A cache for a different list of function
+// names ("NAME,NAME:ARG,...") is ignored.
+//
+
+static bool				// O - `true` on success, `false` on error
+scan_load_cache(scan_cache_t *cache,	// I - Scan cache
+                const char   *cachename,// I - Scan cache filename
+                const char   *funcnames)// I - Localization function names
+{
+  int		fd;			// File descriptor
+  struct stat	fileinfo;		// File information
+  char		*ptr,			// Pointer into data
+		*end,			// End of data
+		*name;			// Function names
+  size_t	i, j,			// Looping vars
+		len,			// Length of string
+		clen,			// Length of comment
+		num_files,		// Number of files
+		num_strings;		// Number of strings
+  scan_file_t	*file;			// Current file
+  scan_string_t	*string;		// Current string
+
+
+  // Read the cache file...
+  if ((fd = open(cachename, O_RDONLY)) < 0)
+    return (false);
+
+  if (fstat(fd, &fileinfo) || (cache->data = malloc((size_t)fileinfo.st_size + 1)) == NULL)
+  {
+    close(fd);
+    return (false);
+  }
+
+  if (read(fd, cache->data, (size_t)fileinfo.st_size) != (ssize_t)fileinfo.st_size)
+  {
+    close(fd);
+    goto error;
+  }
+
+  close(fd);
+
+  ptr  = cache->data;
+  end  = ptr + fileinfo.st_size;
+  *end = '\0';
+
+  // Read the header...
+  if (strncmp(ptr, "SFSCAN 1 ", 9))
+    goto error;
+
+  cache->mtime = strtoll(ptr + 9, &ptr, 10);
+  len          = (size_t)strtoull(ptr, &ptr, 10);
+  num_files    = (size_t)strtoull(ptr, &ptr, 10);
+  num_strings  = (size_t)strtoull(ptr, &ptr, 10);
+
+  if (*ptr++ != '\n' || num_files > (size_t)(end - ptr) || num_strings > (size_t)(end - ptr))
+    goto error;
+
+  if ((name = scan_read_string(&ptr, end, len)) == NULL || strcmp(name, funcnames))
+    goto error;
+
+  if (num_files == 0)
+    return (true);
+
+  if ((cache->files = calloc(num_files, sizeof(scan_file_t))) == NULL || (num_strings > 0 && (cache->strings = calloc(num_strings, sizeof(scan_string_t))) == NULL))
+    goto error;
+
+  // Read the files...
+  for (i = num_files, file = cache->files, string = cache->strings; i > 0; i --, file ++)
+  {
+    file->size        = strtoll(ptr, &ptr, 10);
+    file->mtime       = strtoll(ptr, &ptr, 10);
+    file->hash        = (uint64_t)strtoull(ptr, &ptr, 16);
+    file->num_strings = (size_t)strtoull(ptr, &ptr, 10);
+    len               = (size_t)strtoull(ptr, &ptr, 10);
+
+    if (*ptr++ != '\n' || file->num_strings > (num_strings - (size_t)(string - cache->strings)) || (file->filename = scan_read_string(&ptr, end, len)) == NULL)
+      goto error;
+
+    file->strings = string;
+
+    for (j = file->num_strings; j > 0; j --, string ++)
+    {
+      len  = (size_t)strtoull(ptr, &ptr, 10);
+      clen = (size_t)strtoull(ptr, &ptr, 10);
+
+      if (*ptr++ != '\n' || (string->text = scan_read_string(&ptr, end, len)) == NULL || (clen > 0 && (string->comment = scan_read_string(&ptr, end, clen)) == NULL))
+        goto error;
+    }
+  }
+
+  cache->num_files = num_files;
+
+  return (true);
+
+  // If we get here the cache is unusable...
+  error:
+
+  free(cache->files);
+  free(cache->strings);
+  free(cache->data);
+  memset(cache, 0, sizeof(scan_cache_t));
+
+  return (false);
+}
+
+
+//
+// 'scan_match()' - Check whether a directory entry matches a list of patterns.
+//
+// Patterns containing a "/" are matched against the whole path, otherwise they
+// are matched against the entry name.
+//
+
+static bool				// O - `true` if matched, `false` otherwise
+scan_match(const char * const *patterns,// I - `NULL`-terminated patterns
+           const char         *name,	// I - Entry name
+           const char         *path)	// I - Entry path
+{
+#ifdef _WIN32
+  (void)patterns;
+  (void)name;
+  (void)path;
+
+#else
+  for (; *patterns; patterns ++)
+  {
+    if (!fnmatch(*patterns, strchr(*patterns, '/') ? path : name, 0))
+      return (true);
+  }
+#endif // _WIN32
+
+  return (false);
+}
+
+
+//
+// 'scan_read_list()' - Add the files and directories listed in a file.
+//
+// Each line of the list file contains a single file or directory.  Blank lines
+// are ignored.
+//
+
+static bool				// O - `true` on success, `false` on error
+scan_read_list(scan_job_t *job,		// I - Scan job
+               const char *listfile)	// I - List file or `NULL` for the standard input
+{
+  bool		ret = true;		// Return value
+  FILE		*fp;			// List file
+  char		buffer[1024];		// Buffer for reading lines
+  size_t	len;			// Length of buffer
+  import_buffer_t line;			// Line from list file
+
+
+  if (!listfile)
+    fp = stdin;
+  else if ((fp = fopen(listfile, "r")) == NULL)
+    return (scan_add_file(job, listfile, errno));
+
+  memset(&line, 0, sizeof(line));
+
+  while (ret && fgets(buffer, sizeof(buffer), fp))
+  {
+    // Long lines are read in several pieces...
+    len = strlen(buffer);
+
+    if (!import_append(&line, buffer, len))
+    {
+      ret = false;
+      break;
+    }
+
+    if (len > 0 && buffer[len - 1] != '\n' && !feof(fp))
+      continue;
+
+    // Strip the trailing newline...
+    while (line.len > 0 && (line.data[line.len - 1] == '\n' || line.data[line.len - 1] == '\r'))
+      line.data[-- line.len] = '\0';
+
+    if (line.len > 0)
+      ret = scan_add_path(job, line.data, true);
+
+    line.len = 0;
+  }
+
+  if (fp != stdin)
+    fclose(fp);
+
+  free(line.data);
+
+  return (ret);
+}
+
+
+//
+// 'scan_read_string()' - Read a length-prefixed string from the scan cache.
+//
+
+static char *				// O - String or `NULL` on error
+scan_read_string(char   **ptr,		// IO - Pointer into data
+                 char   *end,		// I  - End of data
+                 size_t len)		// I  - Length of string
+{
+  char	*s = *ptr;			// String
+
+
+  if (s >= end || len >= (size_t)(end - s) || s[len] != '\n')
+    return (NULL);
+
+  s[len] = '\0';
+  *ptr   = s + len + 1;
+
+  return (s);
+}
+
+
+//
+// 'scan_save_cache()' - Save the scan cache.
+//
+// The cache is written to a temporary file and then renamed so that an
+// interrupted scan never leaves a partial cache.
+//
+
+static bool				// O - `true` on success, `false` on error
+scan_save_cache(scan_job_t *job,	// I - Scan job
+                const char *cachename,	// I - Scan cache filename
+                long long  mtime)	// I - Time of scan
+{
+  FILE		*fp;			// Cache file
+  char		tempfile[1024];		// Temporary filename
+  size_t	i, j,			// Looping vars
+		num_strings = 0;	// Number of strings
+  scan_file_t	*file;			// Current file
+  scan_string_t	*string;		// Current string
+
+
+  // Sort the files by name...
+  qsort(job->files, job->num_files, sizeof(scan_file_t *), (int (*)(const void *, const void *))scan_compare_paths);
+
+  for (i = 0; i < job->num_files; i ++)
+    num_strings += job->files[i]->num_strings;
+
+  // Write the cache...
+  snprintf(tempfile, sizeof(tempfile), "%s.%d", cachename, (int)getpid());
+
+  if ((fp = fopen(tempfile, "wb")) == NULL)
+    return (false);
+
+  fprintf(fp, "SFSCAN 1 %lld %u %u %u\n%s\n", mtime, (unsigned)strlen(job->funcnames), (unsigned)job->num_files, (unsigned)num_strings, job->funcnames);
+
+  for (i = 0; i < job->num_files; i ++)
+  {
+    file = job->files[i];
+
+    fprintf(fp, "%lld %lld %016llx %u %u\n%s\n", file->size, file->mtime, (unsigned long long)file->hash, (unsigned)file->num_strings, (unsigned)strlen(file->filename), file->filename);
+
+    for (j = file->num_strings, string = file->strings; j > 0; j --, string ++)
+    {
+      if (string->comment)
+        fprintf(fp, "%u %u\n%s\n%s\n", (unsigned)strlen(string->text), (unsigned)strlen(string->comment), string->text, string->comment);
+      else
+        fprintf(fp, "%u 0\n%s\n", (unsigned)strlen(string->text), string->text);
+    }
+  }
+
+  if (ferror(fp) | fclose(fp) || rename(tempfile, cachename))
+  {
+    int error = errno;			// Save errno
+
+    unlink(tempfile);
+    errno = error;
+
+    return (false);
+  }
+
+  return (true);
+}
+
+
+//
+// 'scan_skip()' - Skip whitespace and comments in C source.
+//
+// If "cstart" is not `NULL`, the contents of the first C comment are returned
+// in "cstart" and "cend".
+//
+
+static const char *			// O - Next token or `NULL` for an unterminated comment
+scan_skip(const char *ptr,		// I - Pointer into source
+          const char *end,		// I - End of source
+          const char **cstart,		// O - Start of comment or `NULL`
+          const char **cend)		// O - End of comment or `NULL`
+{
+  const char	*start;			// Start of comment
+
+
+  while (ptr < end)
+  {
+    if (isspace(*ptr & 255))
+    {
+      ptr ++;
+    }
+    else if ((end - ptr) >= 2 && !memcmp(ptr, "/*", 2))
+    {
+      // C comment
+      for (start = ptr += 2; (end - ptr) >= 2 && memcmp(ptr, "*/", 2); ptr ++);
+
+      if ((end - ptr) < 2)
+        return (NULL);
+
+      if (cstart && !*cstart)
+      {
+        *cstart = start;
+        *cend   = ptr;
+      }
+
+      ptr += 2;
+    }
+    else if ((end - ptr) >= 2 && !memcmp(ptr, "//", 2))
+    {
+      // C++ comment
+      while (ptr < end && *ptr != '\n')
+        ptr ++;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  return (ptr);
+}
+
+
+//
+// 'scan_skip_arg()' - Skip a function argument in C source.
+//
+// Nested parenthesis, brackets, braces, and string and character literals
+// are skipped.
+//
+
+static const char *			// O - Start of next argument or `NULL` if none
+scan_skip_arg(const char *ptr,		// I - Pointer into source
+              const char *end)		// I - End of source
+{
+  int	depth = 0;			// Nesting depth
+  char	quote;				// Quote character
+
+
+  while ((ptr = scan_skip(ptr, end, NULL, NULL)) != NULL && ptr < end)
+  {
+    if (*ptr == '\"' || *ptr == '\'')
+    {
+      // Skip string or character literal...
+      for (quote = *ptr ++; ptr < end && *ptr != quote && *ptr != '\n'; ptr ++)
+      {
+        if (*ptr == '\\')
+          ptr ++;
+      }
+
+      if (ptr >= end || *ptr != quote)
+        return (NULL);
+    }
+    else if (*ptr == '(' || *ptr == '[' || *ptr == '{')
+    {
+      depth ++;
+    }
+    else if (*ptr == ')' || *ptr == ']' || *ptr == '}')
+    {
+      if (depth == 0)
+        return (NULL);			// End of call
+
+      depth --;
+    }
+    else if (*ptr == ',' && depth == 0)
+    {
+      return (ptr + 1);
+    }
+
+    ptr ++;
+  }
+
+  return (NULL);
+}
+
+
+//
+// 'scan_thread()' - Scan source files until there are none left.
+//
+// Files are taken from the scan job queue, waiting for more files until all
+// of them have been added.
+//
+
+static void *				// O - Thread exit status (unused)
+scan_thread(scan_job_t *job)		// I - Scan job
+{
+  scan_file_t	*file;			// Next file
+
+
+  for (;;)
+  {
+    // Get the next file to scan...
+#ifndef _WIN32
+    pthread_mutex_lock(&job->mutex);
+
+    while (job->next_file >= job->num_files && !job->done)
+      pthread_cond_wait(&job->cond, &job->mutex);
+#endif // !_WIN32
+
+    if (job->next_file < job->num_files)
+      file = job->files[job->next_file ++];
+    else
+      file = NULL;
+
+#ifndef _WIN32
+    pthread_mutex_unlock(&job->mutex);
+#endif // !_WIN32
+
+    if (!file)
+      break;
+
+    scan_file(job, file);
+  }
+
+  return (NULL);
+}
+
+
+//
+// 'scan_walk()' - Walk a directory, adding source files to a scan job.
+//
+// The entries in each directory are sorted by name so that the order of files
+// does not depend on the filesystem.  Hidden files and directories, symbolic
+// links to directories, and entries matching an exclude pattern are skipped.
+// Files are added if they match an include pattern.
+//
+
+static bool				// O - `true` on success, `false` on error
+scan_walk(scan_job_t *job,		// I - Scan job
+          const char *dirname)		// I - Directory to walk
+{
+#ifdef _WIN32
+  return (scan_add_file(job, dirname, EISDIR));
+
+#else
+  bool		ret = true;		// Return value
+  DIR		*dir;			// Directory
+  struct dirent	*dent;			// Directory entry
+  char		**names = NULL,		// Entry names
+		**temp;			// New names array
+  import_buffer_t path;			// Entry path
+  size_t	i,			// Looping var
+		num_names = 0,		// Number of names
+		alloc_names = 0;	// Allocated names
+  struct stat	fileinfo;		// Entry information
+
+
+  // Read and sort the directory entries...
+  if ((dir = opendir(dirname)) == NULL)
+    return (scan_add_file(job, dirname, errno));
+
+  while ((dent = readdir(dir)) != NULL)
+  {
+    if (dent->d_name[0] == '.')
+      continue;				// Skip hidden files, ".", and ".."
+
+    if (num_names >= alloc_names)
+    {
+      if ((temp = realloc(names, (alloc_names + 64) * sizeof(char *))) == NULL)
+      {
+        ret = false;
+        break;
+      }
+
+      names       = temp;
+      alloc_names += 64;
+    }
+
+    if ((names[num_names] = strdup(dent->d_name)) == NULL)
+    {
+      ret = false;
+      break;
+    }
+
+    num_names ++;
+  }
+
+  closedir(dir);
+
+  if (num_names > 1)
+    qsort(names, num_names, sizeof(char *), (int (*)(const void *, const void *))scan_compare_names);
+
+  // Add the files and walk the subdirectories...
+  memset(&path, 0, sizeof(path));
+
+  for (i = 0; i < num_names && ret; i ++)
+  {
+    path.len = 0;
+
+    if (!import_append(&path, dirname, strlen(dirname)) || ((!dirname[0] || dirname[strlen(dirname) - 1] != '/') && !import_append(&path, "/", 1)) || !import_append(&path, names[i], strlen(names[i])))
+    {
+      ret = false;
+      break;
+    }
+
+    if (scan_match(job->excludes, names[i], path.data))
+      continue;
+
+    if (lstat(path.data, &fileinfo))
+    {
+      // Report paths that are too long, etc. but not files that were removed...
+      if (errno != ENOENT)
+        ret = scan_add_file(job, path.data, errno);
+      continue;
+    }
+
+    if (S_ISDIR(fileinfo.st_mode))
+      ret = scan_walk(job, path.data);
+    else if ((S_ISREG(fileinfo.st_mode) || (S_ISLNK(fileinfo.st_mode) && !stat(path.data, &fileinfo) && S_ISREG(fileinfo.st_mode))) && scan_match(job->includes, names[i], path.data))
+      ret = scan_add_file(job, path.data, 0);
+  }
+
+  for (i = 0; i < num_names; i ++)
+    free(names[i]);
+
+  free(names);
+  free(path.data);
+
+  return (ret);
+#endif // _WIN32
+}
+
+
+//
+// 'sync_file()' - Merge the base strings into a locale strings file and export
+//                 it as a C header file.
+//
+
+static void
+sync_file(sync_job_t  *job,		// I - Sync job
+          sync_file_t *file)		// I - Locale strings file
+{
+  sf_t		*lsf,			// Locale strings
+		*msf;			// Copy of base strings
+  _sf_pair_t	*pair;			// Current base pair
+  size_t	count;			// Number of pairs remaining
+  bool		merged;			// Merged strings?
+
+
+  // Open the locale strings file, which is created as needed...
+  lsf = sfNew();
+  if (!sfLoadFile(lsf, file->filename) && errno != ENOENT)
+  {
+    snprintf(file->error, sizeof(file->error), "%s", sfGetError(lsf));
+    sfDelete(lsf);
+    return;
+  }
+
+  file->loaded = true;
+
+  // Merging consumes the pairs, so merge a copy of the (sorted) base strings...
+  msf = sfNew();
+  if ((msf->pairs = calloc(job->sf->num_pairs + 1, sizeof(_sf_pair_t))) != NULL)
+  {
+    msf->alloc_pairs = job->sf->num_pairs + 1;
+
+    for (count = job->sf->num_pairs, pair = job->sf->pairs; count > 0; count --, pair ++)
+    {
+      if (!_sfAddPair(msf, pair->key, pair->text, pair->comment))
+        break;
+    }
+
+    msf->need_sort = false;
+  }
+
+  if (!msf->pairs || count > 0)
+  {
+    snprintf(file->error, sizeof(file->error), "%s", strerror(errno));
+    file->status = 1;
+    sfDelete(msf);
+    sfDelete(lsf);
+    return;
+  }
+
+  merged = _sfMergePairs(lsf, msf, job->clean, &file->added, &file->removed);
+
+  sfDelete(msf);
+
+  if (!merged)
+  {
+    snprintf(file->error, sizeof(file->error), "%s", sfGetError(lsf));
+    file->status = 1;
+  }
+  else if ((file->added || file->removed) && !write_strings(lsf, file->filename))
+  {
+    file->status = 1;
+  }
+  else
+  {
+    file->status = export_strings(lsf, file->filename, file->header);
+  }
+
+  sfDelete(lsf);
+}
+
+
+//
+// 'sync_strings()' - Scan source files and update the base and locale strings.
+//
+// The source files are scanned once into the (empty) base strings, which are
+// always written to the base strings file and then merged into each of the
+// locale strings files ("LL.strings") and exported to the corresponding C
+// header file ("LL_strings.h").  The locale files are processed in parallel by
+// up to "num_jobs" threads, and the results are reported in order.
+//
+
+static int				// O - Exit status
+sync_strings(
+    sf_t               *sf,		// I - Base strings (empty)
+    const char         *sfname,		// I - Base strings filename
+    const char * const *funcnames,	// I - Localization function names
+    int                num_jobs,	// I - Number of parallel jobs or 0 for the number of CPUs
+    bool               use_cache,	// I - Use the scan cache?
+    const char * const *includes,	// I - Include patterns or empty for C/C++ source files
+    const char * const *excludes,	// I - Exclude patterns
+    bool               clean,		// I - Remove old strings?
+    int                num_files,	// I - Number of files
+    const char         *files[])	// I - Locale strings files and source files
+{
+  int		i,			// Looping var
+		status = 1,		// Exit status
+		num_sources = 0;	// Number of source files
+  const char	**sources = NULL,	// Source files
+		*ext;			// Filename extension
+  sync_job_t	job;			// Sync job
+  sync_file_t	*file;			// Current locale file
+#ifndef _WIN32
+  pthread_t	*threads = NULL;	// Sync threads
+  int		num_threads = 0;	// Number of sync threads
+#endif // !_WIN32
+
+
+  // Set up the sync job, separating the locale strings files from the source
+  // files...
+  memset(&job, 0, sizeof(job));
+
+  job.sf    = sf;
+  job.clean = clean;
+
+  if ((job.files = calloc((size_t)num_files, sizeof(sync_file_t))) == NULL || (sources = calloc((size_t)num_files + 1, sizeof(char *))) == NULL)
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to allocate memory: %s"), strerror(errno));
+    goto done;
+  }
+
+  for (i = 0; i < num_files; i ++)
+  {
+    if ((ext = strrchr(files[i], '.')) != NULL && !strcmp(ext, ".strings"))
+    {
+      file           = job.files + job.num_files ++;
+      file->filename = files[i];
+
+      snprintf(file->header, sizeof(file->header), "%.*s_strings.h", (int)(ext - files[i]), files[i]);
+    }
+    else
+    {
+      sources[num_sources ++] = files[i];
+    }
+  }
+
+  if (num_sources == 0)
+  {
+    sfPuts(stderr, SFSTR("stringsutil: Expected source filename(s)."));
+    goto done;
+  }
+
+  // Scan the source files into new base strings...
+  if (scan_files(sf, sfname, funcnames, num_jobs, use_cache, true, includes, excludes, num_sources, sources))
+    goto done;
+
+  status = 0;
+
+  if (job.num_files == 0)
+    goto done;
+
+  // Start the sync threads...
+#if !defined(_WIN32) && defined(_SC_NPROCESSORS_ONLN)
+  if (num_jobs < 1)
+    num_jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif // !_WIN32 && _SC_NPROCESSORS_ONLN
+
+  if (num_jobs > (int)job.num_files)
+    num_jobs = (int)job.num_files;
+
+#ifndef _WIN32
+  pthread_mutex_init(&job.mutex, NULL);
+
+  if (num_jobs > 1 && (threads = calloc((size_t)num_jobs - 1, sizeof(pthread_t))) != NULL)
+  {
+    for (; num_threads < (num_jobs - 1); num_threads ++)
+    {
+      if (pthread_create(threads + num_threads, NULL, (void *(*)(void *))sync_thread, &job))
+        break;
+    }
+  }
+#endif // !_WIN32
+
+  sync_thread(&job);
+
+#ifndef _WIN32
+  for (i = 0; i < num_threads; i ++)
+    pthread_join(threads[i], NULL);
+
+  free(threads);
+  pthread_mutex_destroy(&job.mutex);
+#endif // !_WIN32
+
+  // Show the results in order...
+  for (i = 0, file = job.files; i < (int)job.num_files; i ++, file ++)
+  {
+    if (!file->loaded)
+    {
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to load '%s': %s"), file->filename, file->error);
+      status = 1;
+      continue;
+    }
 
-    fclose(fp);
+    if (file->error[0])
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to merge '%s': %s"), file->filename, file->error);
+    else if (file->added || file->removed)
+      sfPrintf(stdout, SFSTR("stringsutil: Added %d string(s), removed %d string(s) in '%s'."), file->added, file->removed, file->filename);
+
+    if (file->status)
+      status = 1;
   }
-  else
+
+  // Free memory and return...
+  done:
+
+  free(job.files);
+  free(sources);
+
+  return (status);
+}
+
+
+//
+// 'sync_thread()' - Synchronize locale strings files until the job is done.
+//
+
+static void *				// O - Thread exit status (unused)
+sync_thread(sync_job_t *job)		// I - Sync job
+{
+  sync_file_t	*file;			// Current file
+
+
+  for (;;)
   {
-    // Import a .strings file...
-    sf_t	*isf;			// Import strings
-    _sf_pair_t	*pair,			// Existing pair
-		*ipair;			// Imported pair
-    size_t	count;			// Number of pairs
+#ifndef _WIN32
+    pthread_mutex_lock(&job->mutex);
+#endif // !_WIN32
 
-    isf = sfNew();
-    if (!sfLoadFile(isf, filename))
+    if (job->next_file < job->num_files)
+      file = job->files + job->next_file ++;
+    else
+      file = NULL;
+
+#ifndef _WIN32
+    pthread_mutex_unlock(&job->mutex);
+#endif // !_WIN32
+
+    if (!file)
+      break;
+
+    sync_file(job, file);
+  }
+
+  return (NULL);
+}
+
+
+//
+// 'translate_decode()' - Restore the format specifiers in a translated string.
+//
+// The caller is responsible for calling @code free@ on the returned string.
+//
+
+static char *				// O - Localized text or `NULL` on error
+translate_decode(const char *s,		// I - Original string
+                 const char *value)	// I - Translated string
+{
+  char		*text,			// Localized text
+		*textptr,		// Pointer into localized text
+		*textend;		// End of localized text
+  size_t	textsize,		// Size of localized text
+		maxlen = 1;		// Length of longest format specifier
+  int		num_formats = 0;	// Number of format specifiers
+  const char	*formats[100],		// Format specifiers
+		*fmtptr;		// Pointer into format specifier
+  long		n;			// Format index
+
+
+  if (!strchr(s, '%'))
+    return (strdup(value));
+
+  // Find the format specifiers in the original string...
+  while ((s = strchr(s, '%')) != NULL && num_formats < 100)
+  {
+    formats[num_formats ++] = s;
+
+    // Skip format specifier...
+    for (s ++; *s; s ++)
     {
-      sfPrintf(stderr, SFSTR("stringsutil: Unable to import '%s': %s"), filename, sfGetError(isf));
-      sfDelete(isf);
-      return (1);
+      if (strchr("aAcCdDeEfFgGinoOpsSuUxX%", *s))
+        break;
     }
 
-    for (count = isf->num_pairs, ipair = isf->pairs; count > 0; count --, ipair ++)
+    if (*s)
+      s ++;
+
+    if ((size_t)(s - formats[num_formats - 1]) > maxlen)
+      maxlen = (size_t)(s - formats[num_formats - 1]);
+  }
+
+  // Each _F# is at least 3 characters long...
+  textsize = strlen(value) + (strlen(value) / 3 + 1) * maxlen + 1;
+
+  if ((text = malloc(textsize)) == NULL)
+    return (NULL);
+
+  // Replace _F# with the original format specifiers...
+  for (textptr = text, textend = text + textsize - 1; *value && textptr < textend;)
+  {
+    if (!strncmp(value, "_F", 2) && isdigit(value[2] & 255))
     {
-      if ((pair = _sfFindPair(sf, ipair->key)) != NULL)
+      if ((n = strtol(value + 2, (char **)&value, 10)) < num_formats)
       {
-        // Existing string, check for differences...
-        if (strcmp(pair->text, ipair->text))
+        *textptr++ = '%';
+
+        for (fmtptr = formats[n] + 1; *fmtptr && textptr < textend; fmtptr ++)
         {
-          // Yes
-          free(pair->text);
-          pair->text = strdup(ipair->text);
-          modified ++;
+          *textptr++ = *fmtptr;
+          if (strchr("aAcCdDeEfFgGinoOpsSuUxX%", *fmtptr))
+            break;
         }
       }
-      else if (addnew)
-      {
-        // Add new string...
-        sfAddString(sf, ipair->key, ipair->text, ipair->comment);
-        added ++;
-      }
-      else
-      {
-        // Ignore...
-        ignored ++;
-      }
     }
-
-    sfDelete(isf);
+    else
+    {
+      *textptr++ = *value++;
+    }
   }
 
-  // Finish up...
-  sfPrintf(stdout, SFSTR("stringsutil: %d added, %d ignored, %d modified."), added, ignored, modified);
+  *textptr = '\0';
 
-  if (added || modified)
-    return (write_strings(sf, sfname) ? 0 : 1);
-  else
-    return (0);
+  return (text);
 }
 
 
 //
-// 'matching_formats()' - Determine whether the key and localized text strings have matching formats.
+// 'translate_encode()' - Protect the format specifiers in a string before
+//                        translation.
+//
+// Each format specifier is replaced by " _F# " so that the translation service
+// leaves it alone.  The caller is responsible for calling @code free@ on the
+// returned string.
 //
 
-static bool				// O - `true` if matching, `false` otherwise
-matching_formats(const char *key,	// I - Key string
-                 const char *text)	// I - Localized text
+static char *				// O - Protected text or `NULL` on error
+translate_encode(const char *s)		// I - Original string
 {
-  int		i,			// Looping var
-		num_fmts = 0;		// Number of formats
-  const char	*keyfmts[100],		// Formats from key string
-		*textfmts[100],		// Formats from text string
-		*ptr;			// Pointer into string
+  char		*text,			// Protected text
+		*textptr;		// Pointer into protected text
+  size_t	textsize;		// Size of protected text
+  int		num_formats = 0;	// Number of format specifiers
 
 
-  // First collect the formats from the key string...
-  memset(keyfmts, 0, sizeof(keyfmts));
-  for (ptr = strchr(key, '%'), i = 0; ptr && i < 100; ptr = strchr(ptr + 1, '%'))
+  if (!strchr(s, '%'))
+    return (strdup(s));
+
+  // Each format specifier is replaced by at most 6 characters...
+  textsize = 6 * strlen(s) + 1;
+
+  if ((text = malloc(textsize)) == NULL)
+    return (NULL);
+
+  for (textptr = text; *s;)
   {
-    ptr ++;
-    if (*ptr == '%')
+    // Copy non-format text...
+    if (*s != '%' || num_formats >= 100)
     {
-      // Skip %%...
-      ptr ++;
+      *textptr++ = *s++;
       continue;
     }
 
-    if (isdigit(*ptr & 255) && ptr[1] == '$')
-    {
-      // 1-digit positional parameter
-      i   = *ptr - '1';
-      ptr += 2;
-    }
-    else if (isdigit(*ptr & 255) && isdigit(ptr[1] & 255) && ptr[2] == '$')
+    // Replace % with _F#...
+    snprintf(textptr, textsize - (size_t)(textptr - text), " _F%d ", num_formats ++);
+    textptr += strlen(textptr);
+
+    // Skip format specifier...
+    for (s ++; *s; s ++)
     {
-      // 2-digit positional parameter
-      i = (*ptr - '0') * 10 + ptr[1] - '1';
-      ptr += 3;
+      if (strchr("aAcCdDeEfFgGinoOpsSuUxX%", *s))
+        break;
     }
 
-    keyfmts[i ++] = ptr;
-    if (i > num_fmts)
-      num_fmts = i;
+    if (*s)
+      s ++;
   }
 
-  if (ptr)
-    return (false);
+  *textptr = '\0';
+
+  return (text);
+}
+
+
+//
+// 'translate_memory_add()' - Add a translation to the translation memory.
+//
+// The translation is appended to the memory file so that later runs can use
+// it.
+//
+
+static bool				// O - `true` on success, `false` on error
+translate_memory_add(
+    translate_memory_t *tm,		// I - Translation memory
+    const char         *text,		// I - Source text
+    const char         *localized)	// I - Localized text
+{
+  translate_entry_t *entry;		// Current entry
+  size_t	i,			// Looping var
+		mask;			// Hash mask
+  uint64_t	hash = translate_memory_hash(text);
+					// Hash of source text
 
-  // Then the formats for the text string...
-  memset(textfmts, 0, sizeof(textfmts));
-  for (ptr = strchr(text, '%'), i = 0; ptr && i < 100; ptr = strchr(ptr + 1, '%'))
+
+  // Grow the hash table as needed...
+  if ((tm->num_entries + 1) > (tm->alloc_entries / 4 * 3))
   {
-    ptr ++;
-    if (*ptr == '%')
-    {
-      // Skip %%...
-      ptr ++;
-      continue;
-    }
+    translate_entry_t	*entries,	// New hash table
+			*oldentry;	// Current old entry
+    size_t		alloc = tm->alloc_entries ? 2 * tm->alloc_entries : 1024;
+					// New size of hash table
 
-    if (isdigit(*ptr & 255) && ptr[1] == '$')
-    {
-      // 1-digit positional parameter
-      i   = *ptr - '1';
-      ptr += 2;
-    }
-    else if (isdigit(*ptr & 255) && isdigit(ptr[1] & 255) && ptr[2] == '$')
+    if ((entries = calloc(alloc, sizeof(translate_entry_t))) == NULL)
+      return (false);
+
+    for (i = tm->alloc_entries, oldentry = tm->entries; i > 0; i --, oldentry ++)
     {
-      // 2-digit positional parameter
-      i = (*ptr - '0') * 10 + ptr[1] - '1';
-      ptr += 3;
+      if (!oldentry->text)
+        continue;
+
+      for (mask = alloc - 1, entry = entries + (oldentry->hash & mask); entry->text; entry = entries + ((size_t)(entry - entries + 1) & mask));
+
+      *entry = *oldentry;
     }
 
-    if (i < num_fmts)
-      textfmts[i ++] = ptr;
-    else
+    free(tm->entries);
+
+    tm->entries       = entries;
+    tm->alloc_entries = alloc;
+  }
+
+  // Find an existing or empty entry...
+  for (mask = tm->alloc_entries - 1, entry = tm->entries + (hash & mask); entry->text; entry = tm->entries + ((size_t)(entry - tm->entries + 1) & mask))
+  {
+    if (entry->hash == hash && !strcmp(entry->text, text))
       break;
   }
 
-  if (ptr)
+  if (entry->text)
+  {
+    // Replace existing translation...
+    if (strcmp(entry->localized, localized))
+    {
+      free(entry->localized);
+      entry->localized = strdup(localized);
+    }
+  }
+  else
+  {
+    // Add new translation...
+    entry->hash      = hash;
+    entry->text      = strdup(text);
+    entry->localized = strdup(localized);
+    tm->num_entries ++;
+  }
+
+  if (!entry->text || !entry->localized)
     return (false);
 
-  // Then compare them all...
-  for (i = 0; i < num_fmts; i ++)
+  // Append the translation to the memory file...
+  if (tm->wb.fd >= 0)
   {
-    if (!keyfmts[i] || !textfmts[i] || !compare_formats(keyfmts[i], textfmts[i]))
-      return (false);
+    write_string(&tm->wb, tm->url, false);
+    write_puts(&tm->wb, " ");
+    write_string(&tm->wb, tm->source, false);
+    write_puts(&tm->wb, " ");
+    write_string(&tm->wb, tm->target, false);
+    write_puts(&tm->wb, " ");
+    write_string(&tm->wb, text, false);
+    write_puts(&tm->wb, " ");
+    write_string(&tm->wb, localized, false);
+    write_puts(&tm->wb, "\n");
+    write_flush(&tm->wb);
   }
 
-  return (true);
+  return (!tm->wb.error);
 }
 
 
 //
-// 'merge_strings()' - Merge strings from another strings file.
+// 'translate_memory_close()' - Close a translation memory.
 //
 
-static int				// O - Exit status
-merge_strings(sf_t       *sf,		// I - Strings
-              const char *sfname,	// I - Strings filename
-              const char *filename,	// I - Merge filename
-              bool       clean)		// I - Clean old strings?
+static void
+translate_memory_close(
+    translate_memory_t *tm)		// I - Translation memory
 {
-  sf_t		*msf;			// Strings file to merge
-  _sf_pair_t	*pair,			// Current pair
-		*mpair;			// Merge pair
-  size_t	count;			// Remaining pairs
-  int		added = 0,		// Number of added strings
-		removed = 0;		// Number of removed strings
+  translate_entry_t	*entry;		// Current entry
+  size_t		i;		// Looping var
 
 
-  // Open the merge file...
-  msf = sfNew();
-  if (!sfLoadFile(msf, filename))
+  if (tm->wb.fd >= 0)
   {
-    sfPrintf(stderr, SFSTR("stringsutil: Unable to merge '%s': %s"), filename, sfGetError(msf));
-    sfDelete(msf);
-    return (1);
+    write_flush(&tm->wb);
+    close(tm->wb.fd);
   }
 
-  // Loop through the merge list and add any new strings...
-  for (count = msf->num_pairs, mpair = msf->pairs; count > 0; count --, mpair ++)
+  for (i = tm->alloc_entries, entry = tm->entries; i > 0; i --, entry ++)
   {
-    if (_sfFindPair(sf, mpair->key))
-      continue;
+    free(entry->text);
+    free(entry->localized);
+  }
+
+  free(tm->entries);
+  free(tm);
+}
 
-    added ++;
-    sfAddString(sf, mpair->key, mpair->text, mpair->comment);
+
+//
+// 'translate_memory_find()' - Find a translation in the translation memory.
+//
+
+static const char *			// O - Localized text or `NULL` if not found
+translate_memory_find(
+    translate_memory_t *tm,		// I - Translation memory
+    const char         *text)		// I - Source text
+{
+  translate_entry_t *entry;		// Current entry
+  size_t	mask;			// Hash mask
+  uint64_t	hash;			// Hash of source text
+
+
+  if (tm->num_entries == 0)
+    return (NULL);
+
+  hash = translate_memory_hash(text);
+
+  for (mask = tm->alloc_entries - 1, entry = tm->entries + (hash & mask); entry->text; entry = tm->entries + ((size_t)(entry - tm->entries + 1) & mask))
+  {
+    if (entry->hash == hash && !strcmp(entry->text, text))
+      return (entry->localized);
   }
 
-  // Then clean old messages (if needed)...
-  if (clean)
+  return (NULL);
+}
+
+
+//
+// 'translate_memory_hash()' - Compute the FNV-1a hash of a source text.
+//
+
+static uint64_t				// O - Hash value
+translate_memory_hash(const char *text)	// I - Source text
+{
+  uint64_t	hash = 0xcbf29ce484222325ULL;
+					// Hash value
+
+
+  while (*text)
   {
-    for (count = sf->num_pairs, pair = sf->pairs; count > 0; count --, pair ++)
-    {
-      if (_sfFindPair(msf, pair->key))
-	continue;
+    hash ^= (uint64_t)(*text++ & 255);
+    hash *= 0x100000001b3ULL;
+  }
+
+  return (hash);
+}
+
+
+//
+// 'translate_memory_open()' - Open a translation memory.
+//
+// A translation memory file contains one translation per line with five quoted
+// strings - the translation service URL, source language, target language,
+// source text, and localized text:
+//
+//   "http://localhost:5000" "en" "fr" "Cancel" "Annuler"
+//
+// Translations are only ever appended to the file, so several runs can share
+// it.  Only the translations for the given service and languages are loaded,
+// later lines replace earlier ones, and incomplete lines are ignored.
+//
+
+static translate_memory_t *		// O - Translation memory or `NULL` on error
+translate_memory_open(
+    const char *filename,		// I - Translation memory file
+    const char *url,			// I - Translation service URL
+    const char *source,			// I - Source language
+    const char *target)			// I - Target language
+{
+  translate_memory_t *tm;		// Translation memory
+  int		fd;			// File descriptor
+  struct stat	fileinfo;		// File information
+  char		*data = NULL;		// File data
+  size_t	datasize;		// Size of file data
+  const char	*line,			// Current line
+		*lineend,		// End of current line
+		*dataend,		// End of file data
+		*ptr;			// Pointer into line
+  import_buffer_t fields[5];		// URL, languages, and text
+  int		i;			// Looping var
+  bool		ret = true;		// Return value
+
+
+  // Open the memory file for appending...
+  if ((tm = calloc(1, sizeof(translate_memory_t))) == NULL)
+    return (NULL);
+
+  tm->url    = url;
+  tm->source = source;
+  tm->target = target;
+
+  if ((tm->wb.fd = open(filename, O_RDWR | O_CREAT | O_APPEND, 0644)) < 0 || fstat(tm->wb.fd, &fileinfo))
+  {
+    translate_memory_close(tm);
+    return (NULL);
+  }
+
+  tm->wb.filename = filename;
+
+  if ((datasize = (size_t)fileinfo.st_size) == 0)
+    return (tm);
+
+  // Map the existing translations into memory...
+  fd = tm->wb.fd;
+
+#ifdef _WIN32
+  if ((data = malloc(datasize)) != NULL && read(fd, data, (unsigned)datasize) != (int)datasize)
+  {
+    free(data);
+    data = NULL;
+  }
+
+#else
+  if ((data = mmap(NULL, datasize, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+    data = NULL;
+#endif // _WIN32
+
+  if (!data)
+  {
+    translate_memory_close(tm);
+    return (NULL);
+  }
 
-      removed ++;
+  // Load the translations for this service and languages...
+  memset(fields, 0, sizeof(fields));
 
-      _sfRemovePair(sf, pair);
+  for (line = data, dataend = data + datasize; line < dataend && ret; line = lineend + 1)
+  {
+    if ((lineend = memchr(line, '\n', (size_t)(dataend - line))) == NULL)
+      break;				// Incomplete line
 
-      pair --;
-      count --;
+    for (i = 0, ptr = line; i < 5 && ptr; i ++)
+    {
+      while (ptr < lineend && *ptr == ' ')
+        ptr ++;
 
-      if (count == 0)
+      if (!fields[i].data && !import_append(fields + i, "", 0))
+      {
+        ret = false;
         break;
+      }
+
+      fields[i].len     = 0;
+      fields[i].data[0] = '\0';
+
+      if (ptr >= lineend || *ptr != '\"')
+        ptr = NULL;
+      else
+        ptr = import_quoted(fields + i, ptr, lineend);
+    }
+
+    if (!ret || ptr != lineend)
+      continue;				// Bad line
+
+    if (!strcmp(fields[0].data, url) && !strcmp(fields[1].data, source) && !strcmp(fields[2].data, target))
+    {
+      // Add the translation without writing it to the file again...
+      tm->wb.fd = -1;
+      ret       = translate_memory_add(tm, fields[3].data, fields[4].data);
+      tm->wb.fd = fd;
     }
   }
 
-  sfDelete(msf);
+  for (i = 0; i < 5; i ++)
+    free(fields[i].data);
 
-  if (added || removed)
+#ifdef _WIN32
+  free(data);
+#else
+  munmap(data, datasize);
+#endif // _WIN32
+
+  if (!ret)
   {
-    sfPrintf(stdout, SFSTR("stringsutil: Added %d string(s), removed %d string(s)."), added, removed);
-    return (write_strings(sf, sfname) ? 0 : 1);
+    translate_memory_close(tm);
+    return (NULL);
   }
 
-  return (0);
+  return (tm);
 }
 
 
 //
-// 'report_strings()' - Report how many strings are translated.
+// 'translate_read()' - Read the response to a translation request.
+//
+// The response is parsed as it is read from the connection.  Each string in
+// the "translatedText" member is unescaped into a single reusable buffer and
+// then stored in the corresponding item.  The format specifiers are restored
+// later for each pair since duplicates may use different specifiers.  Unknown
+// members are skipped.
 //
 
-static int				// O - Exit status
-report_strings(sf_t       *sf,		// I - Strings
-               const char *filename,	// I - Comparison filename
-               bool       verbose)	// I - Be verbose?
+static void
+translate_read(http_t            *http,	// I - Connection to service
+               translate_batch_t *batch)// I - Batch to update
 {
-  sf_t		*rsf;			// Strings file to report
-  _sf_pair_t	*pair,			// Current pair
-		*rpair;			// Report pair
-  size_t	count;			// Number of pairs
-  int		total,			// Total messages
-		errors = 0,		// Number of errors
-		translated = 0,		// Translated messages
-		missing = 0,		// Missing messages
-		old = 0,		// Old messages
-		untranslated = 0;	// Messages not translated
+  json_reader_t	jr;			// JSON reader
+  int		ch;			// Current character
+  size_t	i;			// Looping var
+  char		*text = NULL;		// Current string
+  size_t	textsize = 0;		// Size of string buffer
+  bool		is_text,		// "translatedText" member?
+		is_error;		// "error" member?
+
+
+  jr.http   = http;
+  jr.bufptr = jr.bufend = jr.buffer;
+
+  if (json_skip_space(&jr) != '{')
+    return;
+
+  jr.bufptr ++;
+
+  while (json_skip_space(&jr) == '\"')
+  {
+    // Get the member name...
+    if (!json_read_string(&jr, &text, &textsize) || json_skip_space(&jr) != ':')
+      break;
+
+    jr.bufptr ++;
+
+    is_text  = !strcmp(text, "translatedText");
+    is_error = !strcmp(text, "error");
+    ch       = json_skip_space(&jr);
+
+    if (is_text && ch == '[')
+    {
+      // Array of translated strings, one per item...
+      jr.bufptr ++;
+
+      for (i = 0; (ch = json_skip_space(&jr)) != ']'; i ++)
+      {
+        if (i > 0)
+        {
+          if (ch != ',')
+            goto done;
+
+	  jr.bufptr ++;
+	  ch = json_skip_space(&jr);
+        }
 
+        if (ch == '\"' && i < batch->num_items)
+        {
+          if (!json_read_string(&jr, &text, &textsize))
+            goto done;
 
-  // Open the report file...
-  rsf = sfNew();
-  if (!sfLoadFile(rsf, filename))
-  {
-    sfPrintf(stderr, SFSTR("stringsutil: Unable to report on '%s': %s"), filename, sfGetError(rsf));
-    sfDelete(rsf);
-    return (1);
-  }
+	  if (*text)
+	    batch->items[i].localized = strdup(text);
+        }
+        else if (!json_skip_value(&jr))
+        {
+          goto done;
+        }
+      }
 
-  // Loop through the report list and check strings...
-  for (count = rsf->num_pairs, rpair = rsf->pairs; count > 0; count --, rpair ++)
-  {
-    if ((pair = _sfFindPair(sf, rpair->key)) == NULL)
-    {
-      old ++;
-      continue;
+      jr.bufptr ++;
     }
-
-    if (!matching_formats(rpair->key, rpair->text))
+    else if ((is_text && ch == '\"' && batch->num_items == 1) || (is_error && ch == '\"'))
     {
-      sfPrintf(stderr, SFSTR("stringsutil: Translated format string does not match '%s' in '%s'."), rpair->key, filename);
-      errors ++;
-    }
+      // Single translated string or error message...
+      if (!json_read_string(&jr, &text, &textsize))
+        break;
 
-    if (strcmp(rpair->text, pair->text))
-    {
-      translated ++;
+      if (is_error)
+      {
+        free(batch->error);
+        batch->error = strdup(text);
+      }
+      else if (*text)
+      {
+        batch->items[0].localized = strdup(text);
+      }
     }
-    else
+    else if (!json_skip_value(&jr))
     {
-      if (verbose)
-        sfPrintf(stderr, SFSTR("stringsutil: '%s' is not translated in '%s'."), pair->text, filename);
-
-      untranslated ++;
+      break;
     }
-  }
 
-  // Then look for new messages that haven't been merged...
-  for (count = sf->num_pairs, pair = sf->pairs; count > 0; count --, pair ++)
-  {
-    if (_sfFindPair(rsf, pair->key))
-      continue;
+    if (json_skip_space(&jr) != ',')
+      break;
 
-    missing ++;
+    jr.bufptr ++;
   }
 
-  sfDelete(rsf);
-
-  total = translated + missing + untranslated;
-
-  if (missing || old)
-    sfPrintf(stdout, SFSTR("stringsutil: '%s' needs to be merged, %d missing and %d old string(s)."), filename, missing, old);
-
-  if (total == 0)
-    sfPrintf(stdout, SFSTR("stringsutil: No strings in '%s'."), filename);
-  else
-    sfPrintf(stdout, SFSTR("stringsutil: %d string(s), %d (%d%%) translated, %d (%d%%) untranslated in '%s'."), total, translated, 100 * translated / total, untranslated + missing, 100 * (untranslated + missing) / total, filename);
+  done:
 
-  return (untranslated > (total / 2) || errors > 0 ? 1 : 0);
+  free(text);
 }
 
 
 //
-// 'scan_files()' - Scan source files for localization strings.
+// 'translate_send()' - Send a batch of strings to a LibreTranslate service.
+//
+// Multiple strings are sent as an array of "q" values, and the "translatedText"
+// array in the response is mapped back to the items in the same order.  The
+// batch is marked as done when the request completes or fails.
 //
 
-static int				// O - Exit status
-scan_files(sf_t       *sf,		// I - Strings
-           const char *sfname,		// I - Strings filename
-           const char *funcname,	// I - Localization function name
-           int        num_files,	// I - Number of files
-           const char *files[])		// I - Files
+static void
+translate_send(
+    translate_job_t   *job,		// I - Translation job
+    http_t            *http,		// I - Connection to service
+    translate_batch_t *batch)		// I - Batch to send
 {
-  size_t	fnlen;			// Length of function name
-  int		i;			// Looping var
-//  int		linenum;		// Line number in file
-  FILE		*fp;			// Current file
-  char		line[1024],		// Line from file
-		*lineptr,		// Pointer into line
-		comment[1024],		// Comment string (if any)
-		text[1024],		// Text string
-		*ptr;			// Pointer into comment/text
-  int		changes = 0;		// How many added strings?
+  bool		failed = true;		// Did the request fail?
+  size_t	i;			// Looping var
+  int		num_request = 0;	// Number of request values
+  cups_option_t	*request = NULL;	// Request values
+  char		*q,			// Array of strings
+		*qptr,			// Pointer into array
+		*qend;			// End of array
+  size_t	qsize;			// Size of array
+  char		*request_json;		// JSON data for request
+  size_t	request_len;		// Request length
+  http_state_t	state;			// Current HTTP state
+
+
+  // Don't send anything after losing the connection to the service...
+#ifndef _WIN32
+  pthread_mutex_lock(&job->mutex);
+#endif // !_WIN32
+
+  if (job->failed)
+    batch->failed = true;
+
+#ifndef _WIN32
+  pthread_mutex_unlock(&job->mutex);
+#endif // !_WIN32
 
+  if (batch->failed)
+    goto done;
 
-  // Scan each file for strings...
-  fnlen = strlen(funcname);
+  // Build the request...
+  for (i = 0; i < (size_t)job->num_request; i ++)
+    num_request = cupsAddOption(job->request[i].name, job->request[i].value, num_request, &request);
 
-  for (i = 0; i < num_files; i ++)
+  if (batch->num_items == 1)
+  {
+    num_request = cupsAddOption("q", batch->items[0].text, num_request, &request);
+  }
+  else
   {
-    if ((fp = fopen(files[i], "r")) == NULL)
+    for (i = 0, qsize = 3; i < batch->num_items; i ++)
+      qsize += 2 * strlen(batch->items[i].text) + 4;
+
+    if ((q = malloc(qsize)) == NULL)
     {
-      sfPrintf(stderr, SFSTR("stringsutil: Unable to open source file '%s': %s"), files[i], strerror(errno));
-      return (1);
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to allocate memory: %s"), strerror(errno));
+      goto done;
     }
 
-//    linenum = 0;
+    qend = q + qsize - 2;
+    *q   = '[';
 
-    while (fgets(line, sizeof(line), fp))
+    for (i = 0, qptr = q + 1; i < batch->num_items; i ++)
     {
-      // Look for the function invocation...
-//      linenum ++;
+      if (i > 0)
+        *qptr++ = ',';
 
-      if ((lineptr = strstr(line, funcname)) == NULL)
-        continue;
-
-      while (lineptr)
-      {
-        if ((lineptr == line || strchr(" \t(,{", lineptr[-1]) != NULL) && lineptr[fnlen] == '(')
-          break;
+      qptr = encode_string(batch->items[i].text, qptr, qend);
+    }
 
-        lineptr = strstr(lineptr + 1, funcname);
-      }
+    *qptr++ = ']';
+    *qptr   = '\0';
 
-      if (!lineptr)
-        continue;
+    num_request = cupsAddOption("q", q, num_request, &request);
+    free(q);
+  }
 
-      // Found "FUNCNAME(", look for comment and text...
-      lineptr += fnlen + 1;
+  if ((request_json = encode_json(num_request, request)) == NULL)
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to allocate memory: %s"), strerror(errno));
+    goto done;
+  }
 
-      comment[0] = '\0';
-      text[0]    = '\0';
+  request_len = strlen(request_json);
 
-      if (!strncmp(lineptr, "/*", 2))
-      {
-        // Comment, copy it...
-        lineptr += 2;
-        while (*lineptr && isspace(*lineptr & 255))
-          lineptr ++;
+  // Send the request...
+  httpSetField(http, HTTP_FIELD_CONTENT_TYPE, "application/json");
+  httpSetLength(http, request_len);
+#if CUPS_VERSION_MAJOR > 2
+  if (!httpWriteRequest(http, "POST", "/translate"))
+#else
+  if (httpPost(http, "/translate"))
+#endif // CUPS_VERSION_MAJOR > 2
+  {
+    if (!httpConnectAgain(http, /*msec*/30000, /*cancel*/NULL))
+    {
+      sfPrintf(stderr, SFSTR("stringsutil: Lost connection to translation server: %s"), cupsGetErrorString());
+      free(request_json);
+      goto done;
+    }
+#if CUPS_VERSION_MAJOR > 2
+    else if (!httpWriteRequest(http, "POST", "/translate"))
+#else
+    else if (httpPost(http, "/translate"))
+#endif // CUPS_VERSION_MAJOR > 2
+    {
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to send translation request: %s"), cupsGetErrorString());
+      free(request_json);
+      goto done;
+    }
+  }
 
-        for (ptr = comment; *lineptr; lineptr ++)
-        {
-          if (!strncmp(lineptr, "*/", 2))
-            break;
-          else if (ptr < (comment + sizeof(comment) - 1))
-            *ptr++ = *lineptr;
-        }
+  if (httpWrite(http, request_json, request_len) < (ssize_t)request_len)
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to send translation request: %s"), cupsGetErrorString());
+    free(request_json);
+    goto done;
+  }
 
-        // Strip trailing whitespace in comment
-        *ptr = '\0';
-        while (ptr > comment && isspace(ptr[-1] & 255))
-          *--ptr = '\0';
+  free(request_json);
 
-        // Abort if the comment isn't finished
-        if (!*lineptr)
-          continue;
+  // Wait for the response...
+  while (httpUpdate(http) == HTTP_STATUS_CONTINUE)
+    ;
 
-        lineptr += 2;
-        while (*lineptr && isspace(*lineptr & 255))
-          lineptr ++;
-      }
+  state = httpGetState(http);
 
-      if (*lineptr != '\"')
-        continue;
+  // Decode the response as it is read...
+  translate_read(http, batch);
 
-      lineptr ++;
-      for (ptr = text; *lineptr && *lineptr != '\"'; lineptr ++)
-      {
-        if (*lineptr == '\\')
-        {
-          // Handle C escape
-          int ch;			// Quoted character
-
-          lineptr ++;
-          if (*lineptr == '\\')
-            ch = '\\';
-          else if (*lineptr == '\"')
-            ch = '\"';
-          else if (*lineptr == 'n')
-            ch = '\n';
-          else if (*lineptr == 'r')
-            ch = '\r';
-          else if (*lineptr == 't')
-            ch = '\t';
-          else if (*lineptr >= '0' && *lineptr <= '3' && lineptr[1] >= '0' && lineptr[1] <= '7' && lineptr[2] >= '0' && lineptr[2] <= '7')
-          {
-            ch = ((*lineptr - '0') << 6) | ((lineptr[1] - '0') << 3) | (lineptr[2] - '0');
-            lineptr += 2;
-          }
-          else
-            ch = *lineptr;
+  if (httpGetState(http) == state)
+    httpFlush(http);			// Flush any remaining data...
 
-          if (ptr < (text + sizeof(text) - 1))
-            *ptr++ = (char)ch;
-        }
-        else if (ptr < (text + sizeof(text) - 1))
-          *ptr++ = *lineptr;
-      }
+  failed = false;
 
-      *ptr = '\0';
+  // Cleanup...
+  done:
 
-      if (*lineptr != '\"')
-        continue;
+  cupsFreeOptions(num_request, request);
 
-      // Check whether the pair already exists...
-      if (!_sfFindPair(sf, text))
-      {
-        // No, add it!
-        sfAddString(sf, text, text, comment[0] ? comment : NULL);
-        changes ++;
-      }
-    }
+#ifndef _WIN32
+  pthread_mutex_lock(&job->mutex);
+#endif // !_WIN32
 
-    fclose(fp);
-  }
+  batch->done = true;
 
-  // Write out any changes as needed...
-  if (changes == 0)
-  {
-    sfPuts(stdout, SFSTR("stringsutil: No new strings."));
-    return (0);
-  }
-  else if (changes == 1)
-  {
-    sfPuts(stdout, SFSTR("stringsutil: 1 new string."));
-  }
-  else
+  if (failed)
   {
-    sfPrintf(stdout, SFSTR("stringsutil: %d new strings."), changes);
+    batch->failed = true;
+    job->failed   = true;
   }
 
-  return (write_strings(sf, sfname) ? 0 : 1);
+#ifndef _WIN32
+  pthread_cond_broadcast(&job->cond);
+  pthread_mutex_unlock(&job->mutex);
+#endif // !_WIN32
 }
 
 
@@ -1628,6 +4895,18 @@ scan_files(sf_t       *sf,		// I - Strings
 // 'translate_strings()' - Do a machine translation of key strings using a
 //                         LibreTranslate service.
 //
+// Untranslated strings are sent in batches of up to "batch_count" strings or
+// "batch_bytes" bytes of text, whichever comes first.  Strings with the same
+// text (after protecting the format specifiers) are only sent once.  Up to
+// "num_jobs" requests are sent at the same time over a pool of connections,
+// and the results are applied to the strings in order.  Strings found in the
+// translation memory are not sent at all.
+//
+// Each accepted translation is also appended to a journal file next to the
+// strings file.  An interrupted run leaves the journal behind, and the next
+// run replays it and continues with the remaining strings.  The journal is
+// removed once all strings have been translated and saved.
+//
 
 static int				// O - Exit status
 translate_strings(sf_t       *sf,	// I - Strings
@@ -1635,36 +4914,57 @@ translate_strings(sf_t       *sf,	// I - Strings
                   const char *url,	// I - Translation service URL
                   const char *apikey,	// I - Translation service API key, if any
                   const char *language,	// I - Language code
-                  const char *filename)	// I - Base strings filename
+                  const char *filename,	// I - Base strings filename
+                  const char *memfile,	// I - Translation memory file, if any
+                  int        num_jobs,	// I - Number of parallel requests
+                  size_t     batch_count,// I - Maximum strings per request
+                  size_t     batch_bytes)// I - Maximum bytes per request
 {
-  http_t	*http;			// Connection to service
+  int		status = 1;		// Exit status
+  translate_job_t job;			// Translation job
+  http_t	**https = NULL;		// Connections to service
+  int		num_https = 0;		// Number of connections
   char		scheme[32],		// URL scheme
 		userpass[32],		// Username:password
 		host[256],		// Hostname/IP address
 		resource[256];		// Resource path
   int		port;			// Port number
   http_encryption_t encryption;		// Type of encryption to use
-  int		num_request = 0,	// Number of request values
-		num_response;		// Number of response values
-  cups_option_t	*request,		// Request values
-		*response;		// Response values
-  char		*request_json,		// JSON data for request
-		response_json[8192],	// JSON data in response
-		*response_ptr;		// Pointer into response
-  size_t	request_len,		// Request length
-		response_len;		// Response length
-  ssize_t	response_bytes;		// Size of JSON response
-  const char	*value;			// Response value
-  http_state_t	state;			// Current HTTP state
   sf_t		*base_sf;		// Base strings
   const char	*base_text;		// Base localized text
+  translate_memory_t *tm = NULL,	// Translation memory
+		*journal;		// Journal of accepted translations
+  char		journalname[1024];	// Journal filename
+  translate_entry_t *entry;		// Current journal entry
+  bool		finished = false;	// Were all strings translated?
+  const char	*cached;		// Translation from memory
+  char		*localized,		// Localized text
+		*text;			// Text with protected format specifiers
   _sf_pair_t	*pair;			// Current pair
   size_t	count;			// Number of pairs remaining
   int		changes = 0;		// Did we change any strings?
-  int		num_formats;		// Number of format specifiers
-  const char	*formats[100];		// Format specifiers
-  char		text[2048],		// Current text string
-		*textptr;		// Pointer into text string
+  translate_item_t *items = NULL,	// Queued unique strings
+		*dups = NULL,		// Queued duplicate strings
+		*item,			// Current string
+		*dup,			// Current duplicate string
+		**unique = NULL;	// Hash table of unique strings
+  size_t	num_items = 0,		// Number of queued strings
+		num_unique = 0,		// Number of queued unique strings
+		num_dups = 0,		// Number of queued duplicate strings
+		mask,			// Hash mask
+		h,			// Hash index
+		num_applied = 0,	// Number of strings applied
+		num_cached = 0,		// Number of strings from memory
+		num_bytes = 0,		// Number of bytes in current batch
+		len,			// Length of protected text
+		i, j;			// Looping vars
+  translate_batch_t *batch,		// Current batch
+		*next;			// Next batch to send
+  bool		done;			// Is the current batch done?
+#ifndef _WIN32
+  pthread_t	*threads = NULL;	// Request threads
+  int		num_threads = 0;	// Number of request threads
+#endif // !_WIN32
   int		term_width = get_term_width();
 					// Width of terminal or 0 if not
 
@@ -1698,12 +4998,148 @@ translate_strings(sf_t       *sf,	// I - Strings
     return (1);
   }
 
-  // Setup the JSON request values...
+  // Open the translation memory...
+  if (memfile && (tm = translate_memory_open(memfile, url, "en", language)) == NULL)
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to open translation memory '%s': %s"), memfile, strerror(errno));
+    sfDelete(base_sf);
+    return (1);
+  }
+
+  // Replay the journal of an interrupted run...
+  snprintf(journalname, sizeof(journalname), "%s.journal", sfname);
+
+  if ((journal = translate_memory_open(journalname, url, "en", language)) == NULL)
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to open translation journal '%s': %s"), journalname, strerror(errno));
+    if (tm)
+      translate_memory_close(tm);
+    sfDelete(base_sf);
+    return (1);
+  }
+
+  if (journal->num_entries > 0)
+    sfPrintf(stdout, SFSTR("stringsutil: Resuming %lu translation(s) from '%s'."), (unsigned long)journal->num_entries, journalname);
+
+  for (i = journal->alloc_entries, entry = journal->entries; i > 0; i --, entry ++)
+  {
+    if (!entry->text || (pair = _sfFindPair(sf, entry->text)) == NULL || !strcmp(pair->text, entry->localized))
+      continue;
+
+    if ((localized = strdup(entry->localized)) == NULL)
+    {
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to allocate memory: %s"), strerror(errno));
+      translate_memory_close(journal);
+      if (tm)
+        translate_memory_close(tm);
+      sfDelete(base_sf);
+      return (1);
+    }
+
+    free(pair->text);
+    pair->text = localized;
+    changes ++;
+  }
+
+  // Setup the translation job...
+  memset(&job, 0, sizeof(job));
+
   if (apikey)
-    num_request = cupsAddOption("api_key", apikey, num_request, &request);
-  num_request = cupsAddOption("format", "text", num_request, &request);
-  num_request = cupsAddOption("source", "en", num_request, &request);
-  num_request = cupsAddOption("target", language, num_request, &request);
+    job.num_request = cupsAddOption("api_key", apikey, job.num_request, &job.request);
+  job.num_request = cupsAddOption("format", "text", job.num_request, &job.request);
+  job.num_request = cupsAddOption("source", "en", job.num_request, &job.request);
+  job.num_request = cupsAddOption("target", language, job.num_request, &job.request);
+
+  for (mask = 16; mask < (2 * sf->num_pairs); mask *= 2);
+
+  if ((unique = calloc(mask, sizeof(translate_item_t *))) == NULL || (sf->num_pairs > 0 && ((items = calloc(sf->num_pairs, sizeof(translate_item_t))) == NULL || (dups = calloc(sf->num_pairs, sizeof(translate_item_t))) == NULL || (job.batches = calloc(sf->num_pairs, sizeof(translate_batch_t))) == NULL)))
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to allocate memory: %s"), strerror(errno));
+    goto done;
+  }
+
+  // Queue the strings that need to be localized...
+  for (count = sf->num_pairs, pair = sf->pairs; count > 0; count --, pair ++)
+  {
+    if ((base_text = sfGetString(base_sf, pair->key)) == NULL)
+    {
+      sfPrintf(stderr, SFSTR("stringsutil: Ignoring old string '%s'..."), pair->key);
+      continue;
+    }
+
+    if (strcmp(base_text, pair->text) || (journal && translate_memory_find(journal, pair->key)))
+      continue;
+
+    if (tm && (cached = translate_memory_find(tm, pair->text)) != NULL)
+    {
+      // Use the previous translation...
+      if (journal && !translate_memory_add(journal, pair->key, cached))
+      {
+	sfPrintf(stderr, SFSTR("stringsutil: Unable to write translation journal '%s': %s"), journalname, strerror(errno));
+	translate_memory_close(journal);
+	journal = NULL;
+      }
+
+      if (strcmp(pair->text, cached))
+      {
+        if ((localized = strdup(cached)) == NULL)
+        {
+	  sfPrintf(stderr, SFSTR("stringsutil: Unable to allocate memory: %s"), strerror(errno));
+	  goto done;
+        }
+
+        free(pair->text);
+        pair->text = localized;
+        changes ++;
+      }
+
+      num_cached ++;
+      continue;
+    }
+
+    if ((text = translate_encode(pair->text)) == NULL)
+    {
+      sfPrintf(stderr, SFSTR("stringsutil: Unable to allocate memory: %s"), strerror(errno));
+      goto done;
+    }
+
+    num_items ++;
+
+    // Only send the first pair with the same text...
+    for (h = translate_memory_hash(text) & (mask - 1); (item = unique[h]) != NULL; h = (h + 1) & (mask - 1))
+    {
+      if (!strcmp(item->text, text))
+        break;
+    }
+
+    if (item)
+    {
+      for (dup = item; dup->next; dup = dup->next);
+
+      dup->next       = dups + num_dups ++;
+      dup->next->pair = pair;
+
+      free(text);
+      continue;
+    }
+
+    item       = items + num_unique ++;
+    item->pair = pair;
+    item->text = text;
+    unique[h]  = item;
+    len        = strlen(text);
+
+    if (job.num_batches == 0 || job.batches[job.num_batches - 1].num_items >= batch_count || (num_bytes + len) > batch_bytes)
+    {
+      // Start a new batch...
+      batch        = job.batches + job.num_batches ++;
+      batch->items = item;
+      num_bytes    = 0;
+    }
+
+    job.batches[job.num_batches - 1].num_items ++;
+    num_bytes += len;
+  }
 
   // Connect to the server...
   if (!strcmp(scheme, "https") || port == 443)
@@ -1711,244 +5147,288 @@ translate_strings(sf_t       *sf,	// I - Strings
   else
     encryption = HTTP_ENCRYPTION_IF_REQUESTED;
 
-  if ((http = httpConnect(host, port, NULL, AF_UNSPEC, encryption, 1, 30000, NULL)) == NULL)
+  if (num_jobs < 1)
+    num_jobs = 1;
+  if ((size_t)num_jobs > job.num_batches)
+    num_jobs = (int)job.num_batches;	// Don't connect unless there is something to send
+
+  if (num_jobs > 0 && (https = calloc((size_t)num_jobs, sizeof(http_t *))) == NULL)
+  {
+    sfPrintf(stderr, SFSTR("stringsutil: Unable to allocate memory: %s"), strerror(errno));
+    goto done;
+  }
+
+  for (; num_https < num_jobs; num_https ++)
+  {
+    if ((https[num_https] = httpConnect(host, port, NULL, AF_UNSPEC, encryption, 1, 30000, NULL)) == NULL)
+      break;
+  }
+
+  if (num_jobs > 0 && num_https == 0)
   {
     sfPrintf(stderr, SFSTR("stringsutil: Unable to connect to '%s': %s"), url, cupsGetErrorString());
-    cupsFreeOptions(num_request, request);
-    sfDelete(base_sf);
-    return (1);
+    goto done;
+  }
+
+  // Start the request threads, one per extra connection...
+  job.https     = https;
+  job.next_http = 1;
+
+#ifndef _WIN32
+  pthread_mutex_init(&job.mutex, NULL);
+  pthread_cond_init(&job.cond, NULL);
+
+  if (num_https > 1 && (threads = calloc((size_t)num_https - 1, sizeof(pthread_t))) != NULL)
+  {
+    for (; num_threads < (num_https - 1); num_threads ++)
+    {
+      if (pthread_create(threads + num_threads, NULL, (void *(*)(void *))translate_thread, &job))
+        break;
+    }
   }
+#endif // !_WIN32
 
-  // Loop through the strings...
+  // Apply the translations in order, sending requests while we wait...
   if (term_width)
-    sfPrintf(stdout, SFSTR("stringsutil: Translating %lu strings to '%s'..."), (unsigned long)sf->num_pairs, language);
+    sfPrintf(stdout, SFSTR("stringsutil: Translating %lu strings to '%s'..."), (unsigned long)num_items, language);
 
-  for (count = sf->num_pairs, pair = sf->pairs; count > 0; count --, pair ++)
+  for (i = 0, batch = job.batches; i < job.num_batches; i ++, batch ++)
   {
-    // See if this string needs to be localized...
-    if ((base_text = sfGetString(base_sf, pair->key)) == NULL)
+    do
     {
-      if (term_width)
-        putchar('\n');
+#ifndef _WIN32
+      pthread_mutex_lock(&job.mutex);
+#endif // !_WIN32
 
-      sfPrintf(stderr, SFSTR("stringsutil: Ignoring old string '%s'..."), pair->key);
-      continue;
+      if ((done = batch->done) == false && job.next_batch < job.num_batches)
+        next = job.batches + job.next_batch ++;
+      else
+        next = NULL;
+
+#ifndef _WIN32
+      if (!done && !next)
+        pthread_cond_wait(&job.cond, &job.mutex);
+
+      pthread_mutex_unlock(&job.mutex);
+#endif // !_WIN32
+
+      if (next)
+        translate_send(&job, https[0], next);
     }
+    while (!done);
 
-    if (strcmp(base_text, pair->text))
-      continue;
+    if (batch->failed)
+      break;
 
-    // Try translating it...
-    if (term_width)
+    for (j = batch->num_items, item = batch->items; j > 0; j --, item ++)
     {
-      int	pips;		// Progress meter pips
-      char	message[256];	// Message string
+      // Apply the translation to every pair with the same text...
+      for (dup = item; dup; dup = dup->next, num_applied ++)
+      {
+	pair = dup->pair;
+
+	if (term_width)
+	{
+	  int	pips;		// Progress meter pips
+	  char	message[256];	// Message string
+
+	  pips = (int)(10 * (num_applied + 1) / num_items);
+	  message[0] = '[';
+	  if (pips > 0)
+	    memset(message + 1, '=', pips);
+	  if (pips < 10)
+	    memset(message + 1 + pips, ' ', 10 - pips);
+	  snprintf(message + 11, sizeof(message) - 11, "] %-243s", pair->text);
+
+	  if (term_width <= sizeof(message))
+	    message[term_width - 1] = '\0';
+
+	  printf("\r%s", message);
+	  fflush(stdout);
+	}
+	else
+	{
+	  sfPrintf(stdout, SFSTR("stringsutil: Translating '%s'..."), pair->key);
+	}
+
+	if (item->localized)
+	{
+	  // Translated, restore this pair's format specifiers...
+	  if ((localized = translate_decode(pair->text, item->localized)) == NULL)
+	  {
+	    sfPrintf(stderr, SFSTR("stringsutil: Unable to allocate memory: %s"), strerror(errno));
+	    break;
+	  }
+
+	  // Remember the translation...
+	  if (tm && ((cached = translate_memory_find(tm, pair->text)) == NULL || strcmp(cached, localized)) && !translate_memory_add(tm, pair->text, localized))
+	  {
+	    if (term_width)
+	      putchar('\n');
+
+	    sfPrintf(stderr, SFSTR("stringsutil: Unable to write translation memory '%s': %s"), memfile, strerror(errno));
+	    translate_memory_close(tm);
+	    tm = NULL;
+	  }
+
+	  if (journal && !translate_memory_add(journal, pair->key, localized))
+	  {
+	    if (term_width)
+	      putchar('\n');
+
+	    sfPrintf(stderr, SFSTR("stringsutil: Unable to write translation journal '%s': %s"), journalname, strerror(errno));
+	    translate_memory_close(journal);
+	    journal = NULL;
+	  }
 
-      pips = 10 - 10 * count / sf->num_pairs;
-      message[0] = '[';
-      if (pips > 0)
-        memset(message + 1, '=', pips);
-      if (pips < 10)
-        memset(message + 1 + pips, ' ', 10 - pips);
-      snprintf(message + 11, sizeof(message) - 11, "] %-243s", pair->text);
+	  if (strcmp(pair->text, localized))
+	  {
+	    if (term_width == 0)
+	      sfPrintf(stdout, SFSTR("stringsutil: Localized as '%s'."), localized);
 
-      if (term_width <= sizeof(message))
-        message[term_width - 1] = '\0';
+	    free(pair->text);
+	    pair->text = localized;
+	    changes ++;
+	  }
+	  else
+	  {
+	    free(localized);
+	  }
+	}
+	else
+	{
+	  // Not translated, show error...
+	  if (term_width)
+	    putchar('\n');
 
-      printf("\r%s", message);
-      fflush(stdout);
-    }
-    else
-    {
-      sfPrintf(stdout, SFSTR("stringsutil: Translating '%s'..."), pair->key);
+	  sfPrintf(stderr, SFSTR("stringsutil: Unable to translate '%s': %s"), pair->text, batch->error ? batch->error : "???");
+	}
+      }
     }
+  }
 
-    num_formats = 0;
+  finished = i >= job.num_batches;
 
-    if ((value = strchr(pair->text, '%')) != NULL)
-    {
-      // Convert % formats to _F#_ to avoid translation
-      for (value = pair->text, textptr = text; *value;)
-      {
-        // Copy non-format text...
-        while (*value && *value != '%' && textptr < (text + sizeof(text) - 1))
-	  *textptr++ = *value++;
+  // Stop the request threads...
+#ifndef _WIN32
+  pthread_mutex_lock(&job.mutex);
+#endif // !_WIN32
 
-        if (!*value)
-          break;
+  job.next_batch = job.num_batches;
 
-        // Replace % with _F#_...
-	snprintf(textptr, sizeof(text) - (textptr - text), " _F%d ", num_formats);
-	textptr += strlen(textptr);
+#ifndef _WIN32
+  pthread_mutex_unlock(&job.mutex);
 
-	formats[num_formats ++] = value;
-	if (num_formats >= 100)
-	  break;
+  for (i = 0; i < (size_t)num_threads; i ++)
+    pthread_join(threads[i], NULL);
 
-        // Skip format specifier...
-	for (value ++; *value; value ++)
-	{
-	  if (strchr("aAcCdDeEfFgGinoOpsSuUxX%", *value))
-	    break;
-	}
+  free(threads);
+  pthread_cond_destroy(&job.cond);
+  pthread_mutex_destroy(&job.mutex);
+#endif // !_WIN32
 
-	if (*value)
-	  value ++;
-	else
-	  break;
-      }
+  if (term_width)
+    putchar('\n');
 
-      *textptr = '\0';
+  sfPrintf(stdout, SFSTR("stringsutil: Translated %d string(s)."), changes);
 
-      // Add reformatted text...
-      num_request = cupsAddOption("q", text, num_request, &request);
-    }
-    else
-    {
-      // No format strings...
-      num_request = cupsAddOption("q", pair->text, num_request, &request);
-    }
+  if (memfile)
+    sfPrintf(stdout, SFSTR("stringsutil: Found %lu string(s) in translation memory."), (unsigned long)num_cached);
 
-    request_json = encode_json(num_request, request);
-    request_len  = strlen(request_json);
+  if (num_items > 0)
+    sfPrintf(stdout, SFSTR("stringsutil: Sent %lu unique string(s) for %lu string(s), %lu%% duplicates."), (unsigned long)num_unique, (unsigned long)num_items, (unsigned long)(100 * (num_items - num_unique) / num_items));
 
-    httpSetField(http, HTTP_FIELD_CONTENT_TYPE, "application/json");
-    httpSetLength(http, request_len);
-#if CUPS_VERSION_MAJOR > 2
-    if (!httpWriteRequest(http, "POST", "/translate"))
-#else
-    if (httpPost(http, "/translate"))
-#endif // CUPS_VERSION_MAJOR > 2
-    {
-      if (!httpConnectAgain(http, /*msec*/30000, /*cancel*/NULL))
-      {
-	if (term_width)
-	  putchar('\n');
+  if (changes > 0 && !write_strings(sf, sfname))
+    finished = false;
 
-	sfPrintf(stderr, SFSTR("stringsutil: Lost connection to translation server: %s"), cupsGetErrorString());
-	free(request_json);
-	break;
-      }
-#if CUPS_VERSION_MAJOR > 2
-      else if (!httpWriteRequest(http, "POST", "/translate"))
-#else
-      else if (httpPost(http, "/translate"))
-#endif // CUPS_VERSION_MAJOR > 2
-      {
-	if (term_width)
-	  putchar('\n');
+  status = 0;
 
-	sfPrintf(stderr, SFSTR("stringsutil: Unable to send translation request: %s"), cupsGetErrorString());
-	free(request_json);
-	break;
-      }
-    }
+  // Cleanup...
+  done:
 
-    if (httpWrite(http, request_json, request_len) < (ssize_t)request_len)
-    {
-      if (term_width)
-        putchar('\n');
+  for (i = num_unique, item = items; i > 0; i --, item ++)
+  {
+    free(item->text);
+    free(item->localized);
+  }
 
-      sfPrintf(stderr, SFSTR("stringsutil: Unable to send translation request: %s"), cupsGetErrorString());
-      free(request_json);
-      break;
-    }
+  for (i = job.num_batches, batch = job.batches; i > 0; i --, batch ++)
+    free(batch->error);
 
-    free(request_json);
+  for (i = 0; i < (size_t)num_https; i ++)
+    httpClose(https[i]);
 
-    // Wait for the response...
-    while (httpUpdate(http) == HTTP_STATUS_CONTINUE)
-      ;
+  free(https);
+  free(items);
+  free(dups);
+  free(unique);
+  free(job.batches);
+  cupsFreeOptions(job.num_request, job.request);
+  sfDelete(base_sf);
 
-    state = httpGetState(http);
-    if ((response_len = httpGetLength(http)) == 0 || response_len > (sizeof(response_json) - 1))
-      response_len = sizeof(response_len) - 1;
+  if (tm)
+    translate_memory_close(tm);
 
-    for (response_ptr = response_json; response_ptr < (response_json + sizeof(response_json) - 1); response_ptr += response_bytes, response_len -= (size_t)response_bytes)
-    {
-      if ((response_bytes = httpRead(http, response_ptr, response_len)) <= 0)
-        break;
-    }
-    *response_ptr = '\0';
+  if (journal)
+  {
+    // Remove the journal once the translations are saved in the strings file...
+    if (journal->num_entries == 0)
+      finished = true;
 
-    if (httpGetState(http) == state)
-      httpFlush(http);			// Flush any remaining data...
+    translate_memory_close(journal);
 
-    // Decode the response...
-    num_response = decode_json(response_json, &response);
-    if ((value = cupsGetOption("translatedText", num_response, response)) != NULL && *value)
-    {
-      // Translated, replace the localized text...
-      if (num_formats > 0)
-      {
-        // Replace format strings...
-	long		n;		// Format index
-	const char	*fmtptr;	// Pointer into format string
+    if (finished)
+      unlink(journalname);
+  }
 
-        for (textptr = text; *value && textptr < (text + sizeof(text) - 1);)
-        {
-          if (!strncmp(value, "_F", 2) && isdigit(value[2] & 255))
-          {
-            if ((n = strtol(value + 2, (char **)&value, 10)) < num_formats)
-            {
-              *textptr++ = '%';
+  return (status);
+}
 
-              for (fmtptr = formats[n] + 1; *fmtptr && textptr < (text + sizeof(text) - 1); fmtptr ++)
-              {
-                *textptr++ = *fmtptr;
-		if (strchr("aAcCdDeEfFgGinoOpsSuUxX%", *fmtptr))
-		  break;
-              }
-            }
 
-            if (!*value)
-              break;
-          }
-          else
-	    *textptr++ = *value++;
-        }
+//
+// 'translate_thread()' - Send translation requests over a connection.
+//
 
-        *textptr = '\0';
-        value    = text;
-      }
+static void *				// O - Thread exit status (unused)
+translate_thread(translate_job_t *job)	// I - Translation job
+{
+  http_t		*http;		// Connection to service
+  translate_batch_t	*batch;		// Next batch
 
-      if (strcmp(pair->text, value))
-      {
-	if (term_width == 0)
-	  sfPrintf(stdout, SFSTR("stringsutil: Localized as '%s'."), value);
 
-	free(pair->text);
-	pair->text = strdup(value);
-	changes ++;
-      }
-    }
-    else
-    {
-      // Not translated, show error...
-      if (term_width)
-        putchar('\n');
+#ifndef _WIN32
+  pthread_mutex_lock(&job->mutex);
+#endif // !_WIN32
 
-      value = cupsGetOption("error", num_response, response);
-      sfPrintf(stderr, SFSTR("stringsutil: Unable to translate '%s': %s"), pair->text, value ? value : "???");
-    }
+  http = job->https[job->next_http ++];
 
-    cupsFreeOptions(num_response, response);
-  }
+#ifndef _WIN32
+  pthread_mutex_unlock(&job->mutex);
+#endif // !_WIN32
 
-  // Cleanup...
-  if (term_width)
-    putchar('\n');
+  for (;;)
+  {
+    // Get the next batch to send...
+#ifndef _WIN32
+    pthread_mutex_lock(&job->mutex);
+#endif // !_WIN32
 
-  sfPrintf(stdout, SFSTR("stringsutil: Translated %d string(s)."), changes);
+    if (job->next_batch < job->num_batches)
+      batch = job->batches + job->next_batch ++;
+    else
+      batch = NULL;
 
-  if (changes > 0)
-    write_strings(sf, sfname);
+#ifndef _WIN32
+    pthread_mutex_unlock(&job->mutex);
+#endif // !_WIN32
 
-  cupsFreeOptions(num_request, request);
-  sfDelete(base_sf);
-  httpClose(http);
+    if (!batch)
+      break;
 
-  return (0);
+    translate_send(job, http, batch);
+  }
+
+  return (NULL);
 }
 
 
@@ -1965,20 +5445,30 @@ usage(FILE *fp,				// I - Where to send usage
   sfPuts(fp, SFSTR("Options:"));
   sfPuts(fp, SFSTR("  -a                   Add new strings (import)."));
   sfPuts(fp, SFSTR("  -A API-KEY           Specify LibreTranslate API key."));
-  sfPuts(fp, SFSTR("  -c                   Remove old strings (merge)."));
+  sfPuts(fp, SFSTR("  -b COUNT             Specify number of strings per request (translate)."));
+  sfPuts(fp, SFSTR("  -B BYTES             Specify number of bytes per request (translate)."));
+  sfPuts(fp, SFSTR("  -c                   Remove old strings (merge, sync)."));
+  sfPuts(fp, SFSTR("  -C                   Use a cache of scanned files (scan, sync)."));
   sfPuts(fp, SFSTR("  -f FILENAME.strings  Specify strings file."));
+  sfPuts(fp, SFSTR("  -F FORMAT            Specify report format (csv, json, text)."));
+  sfPuts(fp, SFSTR("  -i PATTERN           Include matching files in directories (scan, sync)."));
+  sfPuts(fp, SFSTR("  -j JOBS              Specify number of parallel jobs (report, scan, sync, translate)."));
   sfPuts(fp, SFSTR("  -l LOCALE            Specify locale/language ID."));
+  sfPuts(fp, SFSTR("  -M FILENAME          Specify translation memory file (translate)."));
   sfPuts(fp, SFSTR("  -n NAME              Specify function/macro name for localization."));
   sfPuts(fp, SFSTR("  -T URL               Specify LibreTranslate server URL."));
+  sfPuts(fp, SFSTR("  -v                   Show unlocalized strings (report)."));
+  sfPuts(fp, SFSTR("  -x PATTERN           Exclude matching files and directories (scan, sync)."));
   sfPuts(fp, SFSTR("  --help               Show program help."));
   sfPuts(fp, SFSTR("  --version            Show program version."));
   puts("");
   sfPuts(fp, SFSTR("Commands:"));
-  sfPuts(fp, SFSTR("  export               Export strings to GNU gettext .po or C source file."));
-  sfPuts(fp, SFSTR("  import               Import strings from GNU gettext .po or .strings file."));
+  sfPuts(fp, SFSTR("  export               Export strings to GNU gettext .mo/.po or C source file."));
+  sfPuts(fp, SFSTR("  import               Import strings from GNU gettext .mo/.po or .strings file."));
   sfPuts(fp, SFSTR("  merge                Merge strings from another strings file."));
   sfPuts(fp, SFSTR("  report               Report untranslated strings in the specified strings file(s)."));
   sfPuts(fp, SFSTR("  scan                 Scan C/C++ source files for strings."));
+  sfPuts(fp, SFSTR("  sync                 Scan source files, then merge and export all locale strings files."));
   sfPuts(fp, SFSTR("  translate            Translate strings."));
 
   return (status);
@@ -1986,47 +5476,277 @@ usage(FILE *fp,				// I - Where to send usage
 
 
 //
-// 'write_string()' - Write a quoted C string.
+// 'write_close()' - Flush and close a buffered output file.
+//
+// The output file is only replaced when its contents have changed.
+//
+
+static bool				// O - `true` on success, `false` on error
+write_close(write_buffer_t *wb)		// I - Output file
+{
+  int	error;				// Saved error, if any
+
+
+  write_flush(wb);
+
+  if (wb->error || close(wb->fd))
+  {
+    error = errno;
+    if (wb->error)
+      close(wb->fd);
+    unlink(wb->tempfile);
+    errno = error;
+    return (false);
+  }
+
+  return (write_replace(wb->tempfile, wb->filename));
+}
+
+
+//
+// 'write_data()' - Write bytes to a buffered output file.
 //
 
 static void
-write_string(FILE       *fp,		// I - Output file
-             const char *s,		// I - String
-             bool       code)		// I - Write as embedded code string
+write_data(write_buffer_t *wb,		// I - Output file
+           const char     *data,	// I - Bytes to write
+           size_t         len)		// I - Number of bytes
 {
-  const char *escape = code ? "\\\\" : "\\";
-					// Escape for string
+  ssize_t	bytes;			// Bytes written
 
 
-  if (code)
-    fputs("\\\"", fp);
-  else
-    putc('\"', fp);
+  if ((wb->used + len) > sizeof(wb->buffer))
+    write_flush(wb);
+
+  if (len < sizeof(wb->buffer))
+  {
+    memcpy(wb->buffer + wb->used, data, len);
+    wb->used += len;
+    return;
+  }
+
+  // Write large strings directly...
+  while (len > 0 && !wb->error)
+  {
+    if ((bytes = write(wb->fd, data, len)) > 0)
+    {
+      data += bytes;
+      len  -= (size_t)bytes;
+    }
+    else if (bytes < 0 && errno != EINTR && errno != EAGAIN)
+    {
+      wb->error = true;
+    }
+  }
+}
+
+
+//
+// 'write_flush()' - Write the buffered bytes of an output file.
+//
+
+static void
+write_flush(write_buffer_t *wb)		// I - Output file
+{
+  const char	*data = wb->buffer;	// Bytes to write
+  ssize_t	bytes;			// Bytes written
+
+
+  while (wb->used > 0 && !wb->error)
+  {
+    if ((bytes = write(wb->fd, data, wb->used)) > 0)
+    {
+      data     += bytes;
+      wb->used -= (size_t)bytes;
+    }
+    else if (bytes < 0 && errno != EINTR && errno != EAGAIN)
+    {
+      wb->error = true;
+    }
+  }
+
+  wb->used = 0;
+}
+
+
+//
+// 'write_open()' - Create a buffered output file.
+//
+// The output is written to a temporary file that @link write_close@ moves into
+// place.  The temporary file gets the permissions of any existing file and is
+// created next to the target of a symbolic link, so the link is preserved.
+//
+
+static bool				// O - `true` on success, `false` on error
+write_open(write_buffer_t *wb,		// I - Output file
+           const char     *filename)	// I - Filename
+{
+  struct stat	fileinfo;		// Existing file information
+
+
+  wb->filename = write_target(filename, wb->target, sizeof(wb->target));
+  wb->error    = false;
+  wb->used     = 0;
+
+  snprintf(wb->tempfile, sizeof(wb->tempfile), "%s.%d", wb->filename, (int)getpid());
+
+  if (stat(wb->filename, &fileinfo))
+    fileinfo.st_mode = 0666;
+
+  return ((wb->fd = open(wb->tempfile, O_WRONLY | O_CREAT | O_TRUNC | O_EXCL, fileinfo.st_mode & 0777)) >= 0);
+}
+
+
+//
+// 'write_puts()' - Write a string to a buffered output file.
+//
+
+static void
+write_puts(write_buffer_t *wb,		// I - Output file
+           const char     *s)		// I - String
+{
+  write_data(wb, s, strlen(s));
+}
+
+
+//
+// 'write_replace()' - Replace a file with a temporary file if it has changed.
+//
+// Leaving an unchanged file alone preserves its modification time, so files
+// that depend on it are not needlessly rebuilt.
+//
+
+static bool				// O - `true` on success, `false` on error
+write_replace(const char *tempfile,	// I - Temporary filename
+              const char *filename)	// I - Filename
+{
+  bool		same = false;		// Are the files the same?
+  struct stat	tempinfo,		// Temporary file information
+		fileinfo;		// Existing file information
+  int		tempfd,			// Temporary file
+		filefd,			// Existing file
+		error;			// Saved error, if any
+  ssize_t	tempbytes,		// Bytes read from temporary file
+		filebytes;		// Bytes read from existing file
+  char		tempbuf[65536],		// Temporary file buffer
+		filebuf[65536];		// Existing file buffer
+
+
+  // Compare the sizes and then the contents of the files...
+  if (!stat(tempfile, &tempinfo) && !stat(filename, &fileinfo) && tempinfo.st_size == fileinfo.st_size)
+  {
+    if ((tempfd = open(tempfile, O_RDONLY)) >= 0)
+    {
+      if ((filefd = open(filename, O_RDONLY)) >= 0)
+      {
+        do
+        {
+          tempbytes = read(tempfd, tempbuf, sizeof(tempbuf));
+          filebytes = read(filefd, filebuf, sizeof(filebuf));
+          same      = tempbytes == filebytes && tempbytes >= 0 && !memcmp(tempbuf, filebuf, (size_t)tempbytes);
+        }
+        while (same && tempbytes > 0);
+
+        close(filefd);
+      }
+
+      close(tempfd);
+    }
+  }
+
+  // Then remove the temporary file or move it into place...
+  if (same)
+  {
+    unlink(tempfile);
+  }
+  else if (rename(tempfile, filename))
+  {
+    error = errno;
+    unlink(tempfile);
+    errno = error;
+    return (false);
+  }
+
+  return (true);
+}
+
 
-  while (*s)
+//
+// 'write_string()' - Write a quoted C string.
+//
+// Runs of characters that don't need escaping are found eight bytes at a time
+// and copied to the output buffer as a block.
+//
+
+static void
+write_string(write_buffer_t *wb,	// I - Output file
+             const char     *s,		// I - String
+             bool           code)	// I - Write as embedded code string
+{
+  const char	*start,			// Start of current run
+		*end;			// End of string
+  uint64_t	word,			// Current group of eight characters
+		quote,			// Zero bytes for quotes
+		backslash,		// Zero bytes for backslashes
+		del;			// Zero bytes for DEL
+  char		temp[16];		// Escaped character
+  static const uint64_t ones = 0x0101010101010101ULL,
+					// 0x01 in every byte
+		highs = 0x8080808080808080ULL;
+					// 0x80 in every byte
+
+
+  write_puts(wb, code ? "\\\"" : "\"");
+
+  for (start = s, end = s + strlen(s); s < end;)
   {
+    // Skip groups of eight characters without control characters, quotes,
+    // backslashes, or DEL...
+    while ((end - s) >= 8)
+    {
+      memcpy(&word, s, sizeof(word));
+
+      quote     = word ^ (0x22 * ones);
+      backslash = word ^ (0x5c * ones);
+      del       = word ^ (0x7f * ones);
+
+      if ((((word - 0x20 * ones) & ~word) | ((quote - ones) & ~quote) | ((backslash - ones) & ~backslash) | ((del - ones) & ~del)) & highs)
+        break;
+
+      s += 8;
+    }
+
+    // Then check individual characters...
+    while (s < end && *s != '\\' && *s != '\"' && (*s & 255) >= ' ' && *s != 0x7f)
+      s ++;
+
+    if (s > start)
+      write_data(wb, start, (size_t)(s - start));
+
+    if (s >= end)
+      break;
+
+    // Escape the current character...
     if (*s == '\\')
-      fprintf(fp, "%s%s", escape, escape);
+      write_puts(wb, code ? "\\\\\\\\" : "\\\\");
     else if (*s == '\"')
-      fprintf(fp, "%s%s\"", escape, code ? "\\" : "");
+      write_puts(wb, code ? "\\\\\\\"" : "\\\"");
     else if (*s == '\n')
-      fprintf(fp, "%sn", escape);
+      write_puts(wb, code ? "\\\\n" : "\\n");
     else if (*s == '\r')
-      fprintf(fp, "%sr", escape);
+      write_puts(wb, code ? "\\\\r" : "\\r");
     else if (*s == '\t')
-      fprintf(fp, "%st", escape);
-    else if ((*s > 0 && *s < ' ') || *s == 0x7f)
-      fprintf(fp, "%s%03o", escape, *s);
+      write_puts(wb, code ? "\\\\t" : "\\t");
     else
-      putc(*s, fp);
+    {
+      snprintf(temp, sizeof(temp), "%s%03o", code ? "\\\\" : "\\", *s);
+      write_puts(wb, temp);
+    }
 
-    s ++;
+    start = ++ s;
   }
 
-  if (code)
-    fputs("\\\"", fp);
-  else
-    putc('\"', fp);
+  write_puts(wb, code ? "\\\"" : "\"");
 }
 
 
@@ -2038,12 +5758,12 @@ static bool				// O - `true` on success, `false` on failure
 write_strings(sf_t       *sf,		// I - Strings
               const char *sfname)	// I - Strings filename
 {
-  FILE		*fp;			// File
+  write_buffer_t wb;			// Output file
   _sf_pair_t	*pair;			// Current pair
   size_t	count;			// Number of pairs
 
 
-  if ((fp = fopen(sfname, "w")) == NULL)
+  if (!write_open(&wb, sfname))
   {
     sfPrintf(stderr, SFSTR(/*Unable to create .strings file*/"stringsutil: Unable to create '%s': %s\n"), sfname, strerror(errno));
     return (false);
@@ -2052,14 +5772,81 @@ write_strings(sf_t       *sf,		// I - Strings
   for (count = sf->num_pairs, pair = sf->pairs; count > 0; count --, pair ++)
   {
     if (pair->comment)
-      fprintf(fp, "/* %s */\n", pair->comment);
-    write_string(fp, pair->key, false);
-    fputs(" = ", fp);
-    write_string(fp, pair->text, false);
-    fputs(";\n", fp);
+    {
+      write_puts(&wb, "/* ");
+      write_puts(&wb, pair->comment);
+      write_puts(&wb, " */\n");
+    }
+
+    write_string(&wb, pair->key, false);
+    write_puts(&wb, " = ");
+    write_string(&wb, pair->text, false);
+    write_puts(&wb, ";\n");
   }
 
-  fclose(fp);
+  if (!write_close(&wb))
+  {
+    sfPrintf(stderr, SFSTR(/*Unable to create .strings file*/"stringsutil: Unable to create '%s': %s\n"), sfname, strerror(errno));
+    return (false);
+  }
 
   return (true);
 }
+
+
+//
+// 'write_target()' - Get the file to write for a filename.
+//
+// If the filename is a symbolic link, the file it points to is returned so
+// that replacing the file does not replace the link.  A link to a file that
+// does not exist yet is followed one level.
+//
+
+static const char *			// O - Filename to write
+write_target(const char *filename,	// I - Filename
+             char       *buffer,	// I - Buffer for link target
+             size_t     bufsize)	// I - Size of buffer
+{
+#ifndef _WIN32
+  struct stat	fileinfo;		// File information
+  char		*target,		// Target of symbolic link
+		link[1024];		// Contents of symbolic link
+  const char	*dirsep;		// Last directory separator in filename
+  ssize_t	linklen;		// Length of symbolic link
+
+
+  if (lstat(filename, &fileinfo) || !S_ISLNK(fileinfo.st_mode))
+    return (filename);
+
+  if ((target = realpath(filename, NULL)) != NULL)
+  {
+    // Use the fully resolved filename...
+    if (strlen(target) < bufsize)
+    {
+      strncpy(buffer, target, bufsize - 1);
+      buffer[bufsize - 1] = '\0';
+      filename = buffer;
+    }
+
+    free(target);
+  }
+  else if ((linklen = readlink(filename, link, sizeof(link) - 1)) > 0)
+  {
+    // The target does not exist, use it relative to the link's directory...
+    link[linklen] = '\0';
+
+    if (link[0] != '/' && (dirsep = strrchr(filename, '/')) != NULL)
+      snprintf(buffer, bufsize, "%.*s/%s", (int)(dirsep - filename), filename, link);
+    else
+      snprintf(buffer, bufsize, "%s", link);
+
+    filename = buffer;
+  }
+
+#else
+  (void)buffer;
+  (void)bufsize;
+#endif // !_WIN32
+
+  return (filename);
+}
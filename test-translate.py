@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+#
+# Stand-in LibreTranslate server for testing StringsUtil.
+#
+# Copyright © 2026 by Michael R Sweet.
+#
+# Licensed under Apache License v2.0.  See the file "LICENSE" for more
+# information.
+#
+# Usage:
+#
+#   ./test-translate.py [--delay SECONDS] [--log FILENAME] [--port PORT]
+#       [--port-file FILENAME]
+#
+# The server accepts POST requests for "/translate" with a "q" string or array
+# of strings and "translates" them to Pig Latin, leaving the "_F#" format
+# placeholders used by "stringsutil translate" alone.  Each request is logged
+# as "POST /translate COUNT" when the "--log" option is used.
+#
+
+import argparse
+import http.server
+import json
+import os
+import re
+import sys
+import threading
+import time
+
+
+WORD_RE = re.compile(r"_F[0-9]+|[A-Za-z]+")
+
+
+def translate(text):
+    """Translate a string to Pig Latin."""
+
+    def word(match):
+        w = match.group(0)
+        if w.startswith("_F") and w[2:].isdigit():
+            return w
+        return w[1:] + w[0] + "ay"
+
+    return WORD_RE.sub(word, text)
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    """Request handler for the stand-in server."""
+
+    protocol_version = "HTTP/1.1"
+    disable_nagle_algorithm = True
+    delay = 0.0
+    log = None
+    lock = threading.Lock()
+
+    def log_message(self, format, *args):
+        """Don't log requests to stderr."""
+        pass
+
+    def respond(self, status, data):
+        """Send a JSON response."""
+        body = json.dumps(data).encode("utf-8")
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+
+        try:
+            self.wfile.write(body)
+        except (BrokenPipeError, ConnectionResetError):
+            # Client went away...
+            pass
+
+    def do_POST(self):
+        """Handle a POST request."""
+        length = int(self.headers.get("Content-Length", "0"))
+        body = self.rfile.read(length)
+
+        if self.path != "/translate":
+            self.respond(404, {"error": "Not Found"})
+            return
+
+        try:
+            request = json.loads(body.decode("utf-8"))
+            q = request["q"]
+        except (KeyError, TypeError, ValueError):
+            self.respond(400, {"error": "Invalid request: missing q parameter"})
+            return
+
+        if self.delay > 0:
+            time.sleep(self.delay)
+
+        if isinstance(q, list):
+            count = len(q)
+            response = {"translatedText": [translate(s) for s in q]}
+        else:
+            count = 1
+            response = {"translatedText": translate(q)}
+
+        if self.log:
+            with self.lock:
+                with open(self.log, "a") as fp:
+                    fp.write("POST /translate %d\n" % count)
+
+        self.respond(200, response)
+
+
+def main():
+    """Main entry."""
+    parser = argparse.ArgumentParser(description="Stand-in LibreTranslate server.")
+    parser.add_argument("--delay", type=float, default=0.0, help="delay for each request in seconds")
+    parser.add_argument("--log", help="log requests to the named file")
+    parser.add_argument("--port", type=int, default=0, help="port to listen on (0 = any)")
+    parser.add_argument("--port-file", help="write the port number to the named file")
+    args = parser.parse_args()
+
+    Handler.delay = args.delay
+    Handler.log = args.log
+
+    server = http.server.ThreadingHTTPServer(("127.0.0.1", args.port), Handler)
+    server.daemon_threads = True
+
+    port = server.server_address[1]
+    if args.port_file:
+        with open(args.port_file + ".tmp", "w") as fp:
+            fp.write("%d\n" % port)
+        os.rename(args.port_file + ".tmp", args.port_file)
+    else:
+        print("Listening on http://127.0.0.1:%d" % port, flush=True)
+
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,946 @@
+//
+// Unit test program for the StringsUtil library.
+//
+// Copyright © 2026 by Michael R Sweet.
+//
+// Licensed under Apache License v2.0.  See the file "LICENSE" for more
+// information.
+//
+// Usage:
+//
+//   ./testsf
+//
+// Each test compares the results of the library functions against an oracle
+// collection of localization strings that is loaded with sfAddString.
+//
+
+#include "sf-private.h"
+#include <sys/wait.h>
+#include <pthread.h>
+
+
+//
+// Constants...
+//
+
+#define TEST_NUM_KEYS	1000		// Number of keys in the oracle
+#define TEST_NUM_LOCALE	100		// Number of keys in each test locale
+
+
+//
+// Local functions...
+//
+
+static sf_t	*make_oracle(void);
+static char	*make_locale(const char *locale);
+static bool	test_get_strings(sf_t *oracle);
+static bool	test_gnu_mo(sf_t *oracle);
+static bool	test_register_directory(sf_t *oracle);
+static bool	test_shared(sf_t *oracle);
+static bool	test_shared_mo(sf_t *oracle);
+static bool	test_stats(sf_t *oracle);
+static bool	test_thread_locale(void);
+static void	*test_thread_locale_cb(const char *locale);
+static bool	verify_strings(sf_t *oracle, sf_t *sf, const char **message);
+
+
+//
+// 'main()' - Run the unit tests.
+//
+
+int					// O - Exit status
+main(void)
+{
+  sf_t		*oracle;		// Oracle strings
+  int		status = 0;		// Exit status
+
+
+  if ((oracle = make_oracle()) == NULL)
+  {
+    puts("Unable to create oracle strings.");
+    return (1);
+  }
+
+  if (!test_shared(oracle))
+    status = 1;
+
+  if (!test_shared_mo(oracle))
+    status = 1;
+
+  if (!test_get_strings(oracle))
+    status = 1;
+
+  if (!test_stats(oracle))
+    status = 1;
+
+  if (!test_gnu_mo(oracle))
+    status = 1;
+
+  if (!test_register_directory(oracle))
+    status = 1;
+
+  if (!test_thread_locale())
+    status = 1;
+
+  sfDelete(oracle);
+
+  return (status);
+}
+
+
+//
+// 'make_locale()' - Create the strings data for a test locale.
+//
+// Each key "Key NNNNN" is localized as "LL NNNNN" for locale "LL".
+//
+
+static char *				// O - Strings data
+make_locale(const char *locale)		// I - Locale name
+{
+  char		*data,			// Strings data
+		*ptr;			// Pointer into data
+  size_t	datasize = 64 * TEST_NUM_LOCALE + 1;
+					// Size of data
+  int		i;			// Looping var
+
+
+  if ((data = malloc(datasize)) == NULL)
+    return (NULL);
+
+  for (i = 0, ptr = data; i < TEST_NUM_LOCALE; i ++, ptr += strlen(ptr))
+    snprintf(ptr, datasize - (size_t)(ptr - data), "\"Key %05d\" = \"%s %05d\";\n", i, locale, i);
+
+  return (data);
+}
+
+
+//
+// 'make_oracle()' - Create the oracle strings.
+//
+// The keys are numbered strings, some with format specifiers, so that the
+// search index has a long common prefix to skip.
+//
+
+static sf_t *				// O - Oracle strings
+make_oracle(void)
+{
+  sf_t		*oracle;		// Oracle strings
+  int		i;			// Looping var
+  char		key[256],		// Key string
+		text[256];		// Localized text
+
+
+  if ((oracle = sfNew()) == NULL)
+    return (NULL);
+
+  for (i = 0; i < TEST_NUM_KEYS; i ++)
+  {
+    if (i % 10)
+    {
+      snprintf(key, sizeof(key), "Key %05d", i);
+      snprintf(text, sizeof(text), "Text %05d", i);
+    }
+    else
+    {
+      snprintf(key, sizeof(key), "Key %05d has %%d item(s).", i);
+      snprintf(text, sizeof(text), "Text %05d has %%d item(s).", i);
+    }
+
+    if (!sfAddString(oracle, key, text, NULL))
+    {
+      sfDelete(oracle);
+      return (NULL);
+    }
+  }
+
+  return (oracle);
+}
+
+
+//
+// 'test_get_strings()' - Test sfGetStrings.
+//
+// The keys are looked up in batches that are not a multiple of the number of
+// interleaved searches, mixed with missing and `NULL` keys, both in a copy of
+// the oracle strings and in a shared catalog.
+//
+
+static bool				// O - `true` on success, `false` on failure
+test_get_strings(sf_t *oracle)		// I - Oracle strings
+{
+  bool		ret = false;		// Return value
+  const char	*message = NULL;	// Failure message
+  sf_t		*sfs[2] = { NULL, NULL };
+					// Strings to test
+  const char	**keys = NULL,		// Keys to look up
+		**texts = NULL,		// Localized text
+		**expected = NULL;	// Expected localized text
+  char		(*missing)[256] = NULL;	// Missing keys
+  size_t	i, j,			// Looping vars
+		num_keys = 0,		// Number of keys
+		num_found = 0,		// Expected number of localized strings
+		found,			// Number of localized strings found
+		count;			// Number of keys in batch
+
+
+  fputs("Batched lookup test: ", stdout);
+  fflush(stdout);
+
+  // Build the list of keys with the expected localized text...
+  if ((keys = calloc(3 * oracle->num_pairs, sizeof(char *))) == NULL || (texts = calloc(3 * oracle->num_pairs, sizeof(char *))) == NULL || (expected = calloc(3 * oracle->num_pairs, sizeof(char *))) == NULL || (missing = calloc(oracle->num_pairs, sizeof(missing[0]))) == NULL)
+  {
+    message = "unable to allocate memory";
+    goto done;
+  }
+
+  for (i = 0; i < oracle->num_pairs; i ++)
+  {
+    keys[num_keys]       = oracle->pairs[i].key;
+    expected[num_keys ++] = oracle->pairs[i].text;
+    num_found ++;
+
+    snprintf(missing[i], sizeof(missing[i]), "%s+", oracle->pairs[i].key);
+    keys[num_keys]       = missing[i];
+    expected[num_keys ++] = missing[i];
+
+    if ((i % 7) == 0)
+      num_keys ++;			// NULL key...
+  }
+
+  // Test a copy of the oracle and a shared catalog...
+  unlink("testsf.sfshare");
+
+  if ((sfs[0] = sfNew()) == NULL)
+  {
+    message = "unable to create strings";
+    goto done;
+  }
+
+  for (i = 0; i < oracle->num_pairs; i ++)
+  {
+    if (!sfAddString(sfs[0], oracle->pairs[i].key, oracle->pairs[i].text, NULL))
+    {
+      message = "unable to add strings";
+      goto done;
+    }
+  }
+
+  if (!sfSaveShared(oracle, "testsf.sfshare") || (sfs[1] = sfAttachShared("testsf.sfshare")) == NULL)
+  {
+    message = "unable to create shared catalog";
+    goto done;
+  }
+
+  for (i = 0; i < 2; i ++)
+  {
+    for (j = 0, found = 0; j < num_keys; j += count)
+    {
+      if ((count = num_keys - j) > 13)
+        count = 13;
+
+      found += sfGetStrings(sfs[i], keys + j, count, texts + j);
+    }
+
+    if (found != num_found)
+    {
+      message = "sfGetStrings did not return the number of localized strings";
+      goto done;
+    }
+
+    for (j = 0; j < num_keys; j ++)
+    {
+      if (texts[j] != expected[j] && (!texts[j] || !expected[j] || strcmp(texts[j], expected[j])))
+      {
+        message = "sfGetStrings did not return the localized text";
+        goto done;
+      }
+    }
+  }
+
+  ret = true;
+
+  done:
+
+  sfDelete(sfs[0]);
+  sfDelete(sfs[1]);
+  unlink("testsf.sfshare");
+
+  free(keys);
+  free(texts);
+  free(expected);
+  free(missing);
+
+  if (ret)
+    puts("PASS");
+  else
+    printf("FAIL (%s)\n", message);
+
+  return (ret);
+}
+
+
+//
+// 'test_gnu_mo()' - Test sfLoadMO with a catalog written by GNU msgfmt.
+//
+// The oracle strings are written to a PO file along with a header, a message
+// context entry for one of the keys, and a plural entry, and then compiled
+// using the "msgfmt" program.  The test is skipped if "msgfmt" is not
+// installed.
+//
+
+static bool				// O - `true` on success, `false` on failure
+test_gnu_mo(sf_t *oracle)		// I - Oracle strings
+{
+  bool		ret = false;		// Return value
+  const char	*message = NULL;	// Failure message
+  sf_t		*sf = NULL;		// Strings to test
+  FILE		*fp;			// PO file
+  size_t	i;			// Looping var
+
+
+  fputs("GNU gettext catalog test: ", stdout);
+  fflush(stdout);
+
+  if (system("msgfmt --version >/dev/null 2>&1"))
+  {
+    puts("SKIP (msgfmt not available)");
+    return (true);
+  }
+
+  unlink("testsf-gnu.mo");
+
+  if ((fp = fopen("testsf.po", "w")) == NULL)
+  {
+    message = "unable to create PO file";
+    goto done;
+  }
+
+  fputs("msgid \"\"\n"
+        "msgstr \"\"\n"
+        "\"Project-Id-Version: testsf\\n\"\n"
+        "\"Language: zz\\n\"\n"
+        "\"MIME-Version: 1.0\\n\"\n"
+        "\"Content-Type: text/plain; charset=UTF-8\\n\"\n"
+        "\"Content-Transfer-Encoding: 8bit\\n\"\n"
+        "\"Plural-Forms: nplurals=2; plural=(n != 1);\\n\"\n"
+        "\n"
+        "msgctxt \"Menu\"\n"
+        "msgid \"Key 00001\"\n"
+        "msgstr \"Context text\"\n"
+        "\n"
+        "msgid \"Key file\"\n"
+        "msgid_plural \"Key files\"\n"
+        "msgstr[0] \"Text file\"\n"
+        "msgstr[1] \"Text files\"\n", fp);
+
+  for (i = 0; i < oracle->num_pairs; i ++)
+    fprintf(fp, "\nmsgid \"%s\"\nmsgstr \"%s\"\n", oracle->pairs[i].key, oracle->pairs[i].text);
+
+  if (fclose(fp))
+  {
+    message = "unable to write PO file";
+    goto done;
+  }
+
+  if (system("msgfmt -o testsf-gnu.mo testsf.po"))
+  {
+    message = "msgfmt failed";
+    goto done;
+  }
+
+  // Load the catalog and verify the lookups...
+  if ((sf = sfNew()) == NULL || !sfLoadMO(sf, "testsf-gnu.mo"))
+  {
+    message = "unable to load message catalog";
+    goto done;
+  }
+
+  if (!verify_strings(oracle, sf, &message))
+    goto done;
+
+  if (strcmp(sfGetString(sf, "Key file"), "Text file"))
+  {
+    message = "sfGetString did not return the singular form";
+    goto done;
+  }
+
+  ret = true;
+
+  done:
+
+  sfDelete(sf);
+  unlink("testsf.po");
+  unlink("testsf-gnu.mo");
+
+  if (ret)
+    puts("PASS");
+  else
+    printf("FAIL (%s)\n", message);
+
+  return (ret);
+}
+
+
+//
+// 'test_register_directory()' - Test sfRegisterDirectory with a message catalog.
+//
+// The directory only contains a "zz.mo" catalog, which is used for both the
+// "zz" and "zz_ZZ" locales since neither has a ".strings" file.
+//
+
+static bool				// O - `true` on success, `false` on failure
+test_register_directory(sf_t *oracle)	// I - Oracle strings
+{
+  bool		ret = false;		// Return value
+  const char	*message = NULL;	// Failure message
+  sf_t		*zz,			// Strings for "zz"
+		*zz_ZZ;			// Strings for "zz_ZZ"
+
+
+  fputs("Directory catalog test: ", stdout);
+  fflush(stdout);
+
+  unlink("testsf.d/zz.mo");
+  rmdir("testsf.d");
+
+  if (mkdir("testsf.d", 0777) || !sfSaveMO(oracle, "testsf.d/zz.mo"))
+  {
+    message = "unable to save message catalog";
+    goto done;
+  }
+
+  sfRegisterDirectory("testsf.d");
+
+  if ((zz = sfGetLocale("zz")) == NULL || (zz_ZZ = sfGetLocale("zz_ZZ.UTF-8")) == NULL)
+  {
+    message = "sfGetLocale failed";
+    goto done;
+  }
+
+  if (zz == zz_ZZ)
+  {
+    message = "sfGetLocale returned the same strings for two locales";
+    goto done;
+  }
+
+  if (!verify_strings(oracle, zz, &message) || !verify_strings(oracle, zz_ZZ, &message))
+    goto done;
+
+  ret = true;
+
+  done:
+
+  // The catalogs stay mapped after the file is removed...
+  unlink("testsf.d/zz.mo");
+  rmdir("testsf.d");
+
+  if (ret)
+    puts("PASS");
+  else
+    printf("FAIL (%s)\n", message);
+
+  return (ret);
+}
+
+
+//
+// 'test_shared()' - Test sfSaveShared and sfAttachShared.
+//
+// The shared catalog is checked in this process and in a forked child process,
+// which is how a prefork server uses it.
+//
+
+static bool				// O - `true` on success, `false` on failure
+test_shared(sf_t *oracle)		// I - Oracle strings
+{
+  bool		ret = false;		// Return value
+  sf_t		*sf = NULL;		// Shared strings
+  const char	*message = NULL;	// Failure message
+  pid_t		pid;			// Child process ID
+  int		status;			// Child exit status
+
+
+  fputs("Shared catalog test: ", stdout);
+  fflush(stdout);
+
+  unlink("testsf.sfshare");
+
+  if (!sfSaveShared(oracle, "testsf.sfshare"))
+  {
+    message = "unable to save shared catalog";
+  }
+  else if ((sf = sfAttachShared("testsf.sfshare")) == NULL)
+  {
+    message = "unable to attach to shared catalog";
+  }
+  else if (!verify_strings(oracle, sf, &message))
+  {
+    // Message already set...
+  }
+  else if (sfAddString(sf, "New key", "New text", NULL))
+  {
+    message = "added string to read-only catalog";
+  }
+  else if ((pid = fork()) < 0)
+  {
+    message = "unable to fork child process";
+  }
+  else if (pid == 0)
+  {
+    // Child process attaches to the same catalog...
+    sfDelete(sf);
+
+    if ((sf = sfAttachShared("testsf.sfshare")) == NULL || !verify_strings(oracle, sf, &message))
+      _exit(1);
+
+    _exit(0);
+  }
+  else if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status))
+  {
+    message = "child process lookups failed";
+  }
+  else
+  {
+    ret = true;
+  }
+
+  sfDelete(sf);
+  unlink("testsf.sfshare");
+
+  if (ret)
+    puts("PASS");
+  else
+    printf("FAIL (%s)\n", message);
+
+  return (ret);
+}
+
+
+//
+// 'test_shared_mo()' - Test sfSaveShared with message catalogs.
+//
+// The oracle strings are split between a pair and two message catalogs, with
+// some keys in more than one of them, so that the shared catalog must use the
+// same strings as lookups in the original localization strings.
+//
+
+static bool				// O - `true` on success, `false` on failure
+test_shared_mo(sf_t *oracle)		// I - Oracle strings
+{
+  bool		ret = false;		// Return value
+  const char	*message = NULL;	// Failure message
+  sf_t		*sf = NULL,		// Strings with message catalogs
+		*mosf = NULL,		// Strings for message catalogs
+		*shsf = NULL;		// Shared strings
+  size_t	i;			// Looping var
+  const char	*text;			// Localized text
+
+
+  fputs("Shared catalog test (message catalogs): ", stdout);
+  fflush(stdout);
+
+  unlink("testsf.mo");
+  unlink("testsf2.mo");
+  unlink("testsf.sfshare");
+
+  // The first catalog has all of the oracle strings but "Key 00001", which is
+  // also added as a pair...
+  if ((sf = sfNew()) == NULL || (mosf = sfNew()) == NULL)
+  {
+    message = "unable to create strings";
+    goto done;
+  }
+
+  for (i = 0; i < oracle->num_pairs; i ++)
+  {
+    if (!strcmp(oracle->pairs[i].key, "Key 00001"))
+      text = "Catalog 00001";
+    else
+      text = oracle->pairs[i].text;
+
+    if (!sfAddString(mosf, oracle->pairs[i].key, text, NULL))
+    {
+      message = "unable to add strings";
+      goto done;
+    }
+  }
+
+  if (!sfSaveMO(mosf, "testsf.mo"))
+  {
+    message = "unable to save message catalog";
+    goto done;
+  }
+
+  sfDelete(mosf);
+
+  // The second catalog has a key that is also in the first one...
+  if ((mosf = sfNew()) == NULL || !sfAddString(mosf, "Key 00002", "Second 00002", NULL) || !sfAddString(mosf, "Extra key", "Extra text", NULL) || !sfSaveMO(mosf, "testsf2.mo"))
+  {
+    message = "unable to save message catalog";
+    goto done;
+  }
+
+  if (!sfAddString(sf, "Key 00001", "Text 00001", NULL) || !sfLoadMO(sf, "testsf.mo") || !sfLoadMO(sf, "testsf2.mo"))
+  {
+    message = "unable to load message catalogs";
+    goto done;
+  }
+
+  // Save and attach to the shared catalog...
+  if (!sfSaveShared(sf, "testsf.sfshare"))
+  {
+    message = "unable to save shared catalog";
+    goto done;
+  }
+
+  if ((shsf = sfAttachShared("testsf.sfshare")) == NULL)
+  {
+    message = "unable to attach to shared catalog";
+    goto done;
+  }
+
+  if (!verify_strings(oracle, sf, &message) || !verify_strings(oracle, shsf, &message))
+    goto done;
+
+  if (strcmp(sfGetString(shsf, "Extra key"), "Extra text"))
+  {
+    message = "shared catalog is missing a string from the second message catalog";
+    goto done;
+  }
+
+  ret = true;
+
+  done:
+
+  sfDelete(sf);
+  sfDelete(mosf);
+  sfDelete(shsf);
+  unlink("testsf.mo");
+  unlink("testsf2.mo");
+  unlink("testsf.sfshare");
+
+  if (ret)
+    puts("PASS");
+  else
+    printf("FAIL (%s)\n", message);
+
+  return (ret);
+}
+
+
+//
+// 'test_stats()' - Test sfEnableStats and sfGetStats.
+//
+// Lookups are only counted after statistics are enabled, and only for the
+// public lookup functions.  Every missing key is either filtered or a false
+// positive, and a key found in a message catalog only counts as a hit.
+//
+
+static bool				// O - `true` on success, `false` on failure
+test_stats(sf_t *oracle)		// I - Oracle strings
+{
+  bool		ret = false;		// Return value
+  const char	*message = NULL;	// Failure message
+  sf_t		*sf = NULL,		// Strings to test
+		*mosf = NULL;		// Strings for message catalog
+  sf_stats_t	stats;			// Lookup statistics
+  size_t	i,			// Looping var
+		num_pairs = oracle->num_pairs;
+					// Number of keys
+  char		missing[256];		// Missing key
+  const char	*keys[3],		// Keys for sfGetStrings
+		*texts[3];		// Localized text
+
+
+  fputs("Lookup statistics test: ", stdout);
+  fflush(stdout);
+
+  unlink("testsf.mo");
+
+  // Create strings with a message catalog of keys that are not in the pairs...
+  if ((sf = sfNew()) == NULL || (mosf = sfNew()) == NULL)
+  {
+    message = "unable to create strings";
+    goto done;
+  }
+
+  for (i = 0; i < num_pairs; i ++)
+  {
+    if (!sfAddString(sf, oracle->pairs[i].key, oracle->pairs[i].text, NULL))
+    {
+      message = "unable to add strings";
+      goto done;
+    }
+  }
+
+  if (!sfAddString(mosf, "Catalog key", "Catalog text", NULL) || !sfSaveMO(mosf, "testsf.mo") || !sfLoadMO(sf, "testsf.mo"))
+  {
+    message = "unable to load message catalog";
+    goto done;
+  }
+
+  // Statistics are disabled by default...
+  sfGetString(sf, oracle->pairs[0].key);
+  sfLoadString(sf, "\"Loaded key\" = \"Loaded text\";\n");
+  sfGetStats(sf, &stats);
+
+  if (stats.lookups || stats.hits || stats.filtered || stats.false_positives)
+  {
+    message = "counted lookups before statistics were enabled";
+    goto done;
+  }
+
+  // Count hits and misses...
+  sfEnableStats(sf, true);
+
+  for (i = 0; i < num_pairs; i ++)
+  {
+    snprintf(missing, sizeof(missing), "%s+", oracle->pairs[i].key);
+
+    sfGetString(sf, oracle->pairs[i].key);
+    sfHasString(sf, missing);
+  }
+
+  sfGetStats(sf, &stats);
+
+  if (stats.lookups != 2 * num_pairs || stats.hits != num_pairs || (stats.filtered + stats.false_positives) != num_pairs)
+  {
+    message = "wrong statistics for sfGetString and sfHasString";
+    goto done;
+  }
+
+  if (stats.filtered < (num_pairs * 9 / 10))
+  {
+    message = "filter rejected too few missing keys";
+    goto done;
+  }
+
+  // Adding a string doesn't count, and a catalog hit only counts as a hit...
+  if (!sfAddString(sf, "Added key", "Added text", NULL))
+  {
+    message = "unable to add string";
+    goto done;
+  }
+
+  keys[0] = "Catalog key";
+  keys[1] = "Added key";
+  keys[2] = "Missing key";
+
+  if (sfGetStrings(sf, keys, 3, texts) != 2 || strcmp(sfGetString(sf, "Catalog key"), "Catalog text"))
+  {
+    message = "sfGetStrings did not find the catalog and added strings";
+    goto done;
+  }
+
+  sfGetStats(sf, &stats);
+
+  if (stats.lookups != (2 * num_pairs + 4) || stats.hits != (num_pairs + 3) || (stats.filtered + stats.false_positives) != (num_pairs + 1))
+  {
+    message = "wrong statistics for sfGetStrings or message catalog";
+    goto done;
+  }
+
+  // Disable statistics...
+  sfEnableStats(sf, false);
+  sfGetString(sf, "Catalog key");
+  sfGetStats(sf, &stats);
+
+  if (stats.lookups != (2 * num_pairs + 4))
+  {
+    message = "counted lookups after statistics were disabled";
+    goto done;
+  }
+
+  ret = true;
+
+  done:
+
+  sfDelete(sf);
+  sfDelete(mosf);
+  unlink("testsf.mo");
+
+  if (ret)
+    puts("PASS");
+  else
+    printf("FAIL (%s)\n", message);
+
+  return (ret);
+}
+
+
+
+//
+// 'test_thread_locale()' - Test sfGetLocale and sfSetThreadLocale.
+//
+// Two threads select different locales and look up every key at the same
+// time using the default localization strings, while the main thread continues
+// to use the process-wide localization.  The "yy_YY" locale uses the strings
+// registered for "yy".
+//
+
+static bool				// O - `true` on success, `false` on failure
+test_thread_locale(void)
+{
+  bool		ret = false;		// Return value
+  const char	*message = NULL;	// Failure message
+  char		*xx = make_locale("xx"),// Strings for "xx"
+		*yy = make_locale("yy");// Strings for "yy"
+  pthread_t	xxthread,		// Thread for "xx"
+		yythread;		// Thread for "yy"
+  void		*xxstatus = NULL,	// Exit status of "xx" thread
+		*yystatus = NULL;	// Exit status of "yy" thread
+
+
+  fputs("Thread locale test: ", stdout);
+  fflush(stdout);
+
+  if (!xx || !yy)
+  {
+    message = "unable to allocate memory";
+    goto done;
+  }
+
+  sfRegisterString("xx", xx);
+  sfRegisterString("yy", yy);
+
+  if (!sfGetLocale("xx") || sfGetLocale("xx") != sfGetLocale("xx.UTF-8"))
+  {
+    message = "sfGetLocale did not return the same strings for a locale";
+    goto done;
+  }
+
+  if (sfGetLocale("xx") == sfGetLocale("yy_YY"))
+  {
+    message = "sfGetLocale returned the same strings for two locales";
+    goto done;
+  }
+
+  if (pthread_create(&xxthread, NULL, (void *(*)(void *))test_thread_locale_cb, "xx"))
+  {
+    message = "unable to create thread";
+    goto done;
+  }
+
+  if (pthread_create(&yythread, NULL, (void *(*)(void *))test_thread_locale_cb, "yy_YY"))
+  {
+    message = "unable to create thread";
+    pthread_join(xxthread, NULL);
+    goto done;
+  }
+
+  pthread_join(xxthread, &xxstatus);
+  pthread_join(yythread, &yystatus);
+
+  if (xxstatus || yystatus)
+    message = xxstatus ? (const char *)xxstatus : (const char *)yystatus;
+  else if (strcmp(sfGetString(NULL, "Key 00001"), "Key 00001"))
+    message = "main thread did not use the process-wide localization";
+  else
+    ret = true;
+
+  done:
+
+  if (ret)
+    puts("PASS");
+  else
+    printf("FAIL (%s)\n", message);
+
+  // The registered strings must remain valid, so "xx" and "yy" are not freed...
+  return (ret);
+}
+
+
+//
+// 'test_thread_locale_cb()' - Look up strings using a thread's locale.
+//
+
+static void *				// O - `NULL` on success, failure message otherwise
+test_thread_locale_cb(
+    const char *locale)			// I - Locale name
+{
+  int		i,			// Looping var
+		pass;			// Current pass
+  char		key[256],		// Key string
+		text[256];		// Expected localized text
+  const char	*s;			// Localized text
+
+
+  if (sfSetThreadLocale(sfGetLocale(locale)) != NULL)
+    return ((void *)"sfSetThreadLocale did not return the previous strings");
+
+  for (pass = 0; pass < 100; pass ++)
+  {
+    for (i = 0; i < TEST_NUM_LOCALE; i ++)
+    {
+      snprintf(key, sizeof(key), "Key %05d", i);
+      snprintf(text, sizeof(text), "%.2s %05d", locale, i);
+
+      if ((s = sfGetString(NULL, key)) == NULL || strcmp(s, text))
+        return ((void *)"sfGetString did not use the thread's locale");
+    }
+  }
+
+  if (sfSetThreadLocale(NULL) != sfGetLocale(locale))
+    return ((void *)"sfSetThreadLocale did not return the previous strings");
+
+  return (NULL);
+}
+
+
+//
+// 'verify_strings()' - Verify lookups against the oracle strings.
+//
+// Every key is looked up with sfGetString and sfHasString, along with keys
+// that are not in the oracle and sort before, between, and after its keys.
+//
+
+static bool				// O - `true` if all lookups match, `false` otherwise
+verify_strings(sf_t       *oracle,	// I - Oracle strings
+               sf_t       *sf,		// I - Strings to verify
+               const char **message)	// O - Failure message
+{
+  size_t	i;			// Looping var
+  const char	*key,			// Key string
+		*text;			// Localized text
+  char		missing[256];		// Missing key string
+
+
+  for (i = 0; i < oracle->num_pairs; i ++)
+  {
+    key = oracle->pairs[i].key;
+
+    if ((text = sfGetString(sf, key)) == key || strcmp(text, oracle->pairs[i].text))
+    {
+      *message = "sfGetString did not return the localized text";
+      return (false);
+    }
+
+    if (!sfHasString(sf, key))
+    {
+      *message = "sfHasString did not find the key";
+      return (false);
+    }
+
+    snprintf(missing, sizeof(missing), "%s+", key);
+
+    if (sfGetString(sf, missing) != missing || sfHasString(sf, missing))
+    {
+      *message = "found a missing key";
+      return (false);
+    }
+  }
+
+  if (sfHasString(sf, ""))
+  {
+    *message = "found the empty key";
+    return (false);
+  }
+
+  if (sfHasString(sf, "A missing key") || sfHasString(sf, "Z missing key"))
+  {
+    *message = "found a missing key";
+    return (false);
+  }
+
+  return (true);
+}